@@ -0,0 +1,122 @@
+/*
+ * MCUboot side of the fast resume handshake, see src/boot_resume.h.
+ *
+ * boot_image_check_hook() runs before MCUboot hashes and checks the
+ * signature of an image. On a wake from System OFF it skips that for the
+ * image the app armed, every other boot takes the regular path.
+ */
+
+#include "boot_resume_layout.h"
+
+#include <bootutil/boot_hooks.h>
+#include <bootutil/fault_injection_hardening.h>
+#include <bootutil/image.h>
+#include <flash_map_backend/flash_map_backend.h>
+
+#include <zephyr/storage/flash_map.h>
+
+#if CONFIG_NRF_GRTC_TIMER
+#include <zephyr/drivers/timer/nrf_grtc_timer.h>
+#endif
+
+#include <nrf.h>
+
+#include <string.h>
+
+BUILD_ASSERT(sizeof(struct boot_resume) <= DT_REG_SIZE(BOOT_RESUME_NODE), "Handshake does not fit boot_resume_ram");
+
+/* Wakes from System OFF by the GRTC or a GPIO DETECT signal */
+#define OFF_WAKE_MASK (RESET_RESETREAS_GRTC_Msk | RESET_RESETREAS_OFF_Msk)
+
+static struct boot_resume *const state = (struct boot_resume *)BOOT_RESUME_ADDR;
+
+static uint32_t now_us(void)
+{
+#if CONFIG_NRF_GRTC_TIMER
+	return (uint32_t)z_nrf_grtc_timer_read();
+#else
+	return 0;
+#endif
+}
+
+/* True when the slot holds the image the app armed */
+static bool slot_is_armed(const struct flash_area *fap)
+{
+	struct image_header header;
+	uint8_t fingerprint[BOOT_RESUME_FINGERPRINT_SIZE];
+
+	if (flash_area_get_off(fap) != state->slot_offset ||
+	    flash_area_read(fap, 0, &header, sizeof(header)) != 0 || header.ih_magic != IMAGE_MAGIC) {
+		return false;
+	}
+
+	uint32_t offset = boot_resume_fingerprint_offset(header.ih_hdr_size, header.ih_img_size,
+							 header.ih_protect_tlv_size);
+
+	return flash_area_read(fap, offset, fingerprint, sizeof(fingerprint)) == 0 &&
+	       memcmp(fingerprint, state->fingerprint, sizeof(fingerprint)) == 0;
+}
+
+fih_ret boot_image_check_hook(int img_index, int slot)
+{
+	const struct flash_area *fap;
+	bool armed;
+
+	if (state->magic != BOOT_RESUME_MAGIC || !state->armed ||
+	    flash_area_open(flash_area_id_from_multi_image_slot(img_index, slot), &fap) != 0) {
+		FIH_RET(FIH_BOOT_HOOK_REGULAR);
+	}
+
+	armed = slot_is_armed(fap);
+	flash_area_close(fap);
+
+	/* Some other image, it is validated and the app arms again if it runs */
+	if (!armed) {
+		FIH_RET(FIH_BOOT_HOOK_REGULAR);
+	}
+
+	state->decided_us = now_us();
+
+	if ((NRF_RESET->RESETREAS & OFF_WAKE_MASK) != 0 && state->fast_left > 0) {
+		state->fast_left--;
+		state->mode = BOOT_RESUME_FAST;
+		FIH_RET(FIH_SUCCESS);
+	}
+
+	/* Validated in full, the app arms again once it runs */
+	state->armed = 0;
+	state->mode = BOOT_RESUME_FULL;
+	FIH_RET(FIH_BOOT_HOOK_REGULAR);
+}
+
+/* The remaining hooks keep the regular behaviour */
+
+int boot_read_image_header_hook(int img_index, int slot, struct image_header *img_head)
+{
+	return BOOT_HOOK_REGULAR;
+}
+
+int boot_perform_update_hook(int img_index, struct image_header *img_head, const struct flash_area *area)
+{
+	return BOOT_HOOK_REGULAR;
+}
+
+int boot_read_swap_state_primary_slot_hook(int image_index, struct boot_swap_state *swap_state)
+{
+	return BOOT_HOOK_REGULAR;
+}
+
+int boot_copy_region_post_hook(int img_index, const struct flash_area *area, size_t size)
+{
+	return 0;
+}
+
+int boot_serial_uploaded_hook(int img_index, const struct flash_area *area, size_t size)
+{
+	return 0;
+}
+
+int boot_img_install_stat_hook(int image_index, int slot, int *img_install_stat)
+{
+	return BOOT_HOOK_REGULAR;
+}
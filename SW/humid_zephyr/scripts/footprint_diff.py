@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""Compare the RAM and flash footprint of two builds.
+
+Usage: footprint_diff.py <baseline zephyr.elf> <new zephyr.elf> [--top N]
+
+Section totals come from the allocated sections of each ELF, split by
+whether they take RAM, flash or both (.data is copied from flash to RAM).
+Symbols that grew or shrank the most are listed below the totals.
+"""
+
+import argparse
+import sys
+
+from elftools.elf.constants import SH_FLAGS
+from elftools.elf.elffile import ELFFile
+
+
+def section_totals(elf):
+    ram = 0
+    flash = 0
+    for section in elf.iter_sections():
+        flags = section['sh_flags']
+        size = section['sh_size']
+        if not flags & SH_FLAGS.SHF_ALLOC or size == 0:
+            continue
+        if flags & SH_FLAGS.SHF_WRITE:
+            ram += size
+            # Initialized data is loaded from flash
+            if section['sh_type'] != 'SHT_NOBITS':
+                flash += size
+        else:
+            flash += size
+    return ram, flash
+
+
+def symbol_sizes(elf):
+    writable = set()
+    for index, section in enumerate(elf.iter_sections()):
+        if section['sh_flags'] & SH_FLAGS.SHF_WRITE:
+            writable.add(index)
+
+    symbols = {}
+    symtab = elf.get_section_by_name('.symtab')
+    if symtab is None:
+        return symbols
+    for symbol in symtab.iter_symbols():
+        size = symbol['st_size']
+        if size == 0 or symbol['st_info']['type'] not in ('STT_OBJECT', 'STT_FUNC'):
+            continue
+        shndx = symbol['st_shndx']
+        kind = 'ram' if isinstance(shndx, int) and shndx in writable else 'flash'
+        symbols[(symbol.name, kind)] = symbols.get((symbol.name, kind), 0) + size
+    return symbols
+
+
+def load(path):
+    with open(path, 'rb') as f:
+        elf = ELFFile(f)
+        return section_totals(elf), symbol_sizes(elf)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='RAM and flash delta between two builds')
+    parser.add_argument('baseline', help='zephyr.elf of the reference build')
+    parser.add_argument('new', help='zephyr.elf of the build to compare')
+    parser.add_argument('--top', type=int, default=20, help='symbols to list (default: 20)')
+    args = parser.parse_args()
+
+    (base_ram, base_flash), base_symbols = load(args.baseline)
+    (new_ram, new_flash), new_symbols = load(args.new)
+
+    print('%-6s %10s %10s %+10s' % ('', 'baseline', 'new', 'delta'))
+    print('%-6s %10d %10d %+10d' % ('RAM', base_ram, new_ram, new_ram - base_ram))
+    print('%-6s %10d %10d %+10d' % ('flash', base_flash, new_flash, new_flash - base_flash))
+
+    deltas = []
+    for key in set(base_symbols) | set(new_symbols):
+        delta = new_symbols.get(key, 0) - base_symbols.get(key, 0)
+        if delta:
+            deltas.append((key, delta))
+    deltas.sort(key=lambda item: -abs(item[1]))
+
+    if deltas and args.top:
+        print()
+        print('%-5s %+8s  %s' % ('', 'delta', 'symbol'))
+        for (name, kind), delta in deltas[:args.top]:
+            print('%-5s %+8d  %s' % (kind, delta, name))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,297 @@
+#!/usr/bin/env python3
+"""Create a delta or compressed OTA patch of a signed app image.
+
+Usage: ota_delta.py [--source <running zephyr.signed.bin>] <new zephyr.signed.bin> <patch>
+       ota_delta.py --apply [--source <running zephyr.signed.bin>] <patch> <output>
+
+The patch rebuilds the new image from the one running on the device, see
+src/delta_patch.h for the format. Without --source it rebuilds the image
+from nothing, which makes it a compressed full image that applies on any
+device. Pack it into the DFU multi image package as image 0x44 instead of
+the full image 0, then wrap that in a Matter OTA image as usual. --apply
+runs the patch the way the device does, to check it.
+
+Matches are found by hashing every position of the running image. A match
+is extended over bytes that differ as long as most still match, the
+differences go out as ADD data, which stays small when code only moved:
+shifted pointers and branch offsets differ in a few bytes each. Repeats
+within the new image are found the same way and go out as MATCH, an exact
+copy of earlier output.
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+
+MAGIC = b'HDP2'
+HEADER = struct.Struct('<4sIII32s32s')
+
+COPY, ADD, INSERT, SEEK, MATCH = range(5)
+
+# Seed length of a match, shorter ones are not worth a COPY
+SEED = 8
+# A match is extended until it loses this much against a plain INSERT
+GIVE_UP = 64
+# Equal bytes shorter than this inside a match go out as zero ADD data
+MIN_COPY = 3
+# Repeats within the new image are looked up by this many bytes
+MATCH_SEED = 4
+# Earlier positions of a seed tried for a MATCH
+MATCH_CHAIN = 16
+
+
+def varint(value):
+    out = bytearray()
+    while value >= 0x80:
+        out.append(value & 0x7f | 0x80)
+        value >>= 7
+    out.append(value)
+    return out
+
+
+def zigzag(value):
+    return value << 1 if value >= 0 else (-value << 1) - 1
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def op(kind, n):
+    return varint(n << 3 | kind)
+
+
+def index_source(source):
+    index = {}
+    for pos in range(len(source) - SEED, -1, -1):
+        # Walking down, the lowest position of a repeated seed wins
+        index[source[pos:pos + SEED]] = pos
+    return index
+
+
+def extend(source, target, s, t):
+    """Length and score of the match at source s, target t, differing bytes included."""
+    best = 0
+    best_score = 0
+    score = 0
+    n = 0
+    limit = min(len(source) - s, len(target) - t)
+    while n < limit:
+        # A matching byte is free, a differing one costs a byte of ADD data
+        score += 1 if source[s + n] == target[t + n] else -1
+        n += 1
+        if score > best_score:
+            best = n
+            best_score = score
+        elif score < best_score - GIVE_UP:
+            break
+    return best, best_score
+
+
+def repeat(target, p, t):
+    """Length of the exact repeat of target p at t, which may overlap it."""
+    n = 0
+    while target[p + n:p + n + 64] == target[t + n:t + n + 64] and t + n + 64 <= len(target):
+        n += 64
+    while t + n < len(target) and target[p + n] == target[t + n]:
+        n += 1
+    return n
+
+
+class History:
+    """Recent positions of every seed in the new image, for MATCH."""
+
+    def __init__(self, target):
+        self.target = target
+        self.chains = {}
+        self.indexed = 0
+
+    def index(self, end):
+        for pos in range(self.indexed, min(end, len(self.target) - MATCH_SEED + 1)):
+            chain = self.chains.setdefault(self.target[pos:pos + MATCH_SEED], [])
+            chain.append(pos)
+            if len(chain) > 2 * MATCH_CHAIN:
+                del chain[:MATCH_CHAIN]
+        self.indexed = max(self.indexed, end)
+
+    def find(self, t):
+        """Best (score, distance, length) of a MATCH at t, or None."""
+        self.index(t)
+        best = None
+        for p in reversed(self.chains.get(self.target[t:t + MATCH_SEED], [])[-MATCH_CHAIN:]):
+            length = repeat(self.target, p, t)
+            score = length - len(op(MATCH, length)) - len(varint(t - p))
+            if best is None or score > best[0]:
+                best = (score, t - p, length)
+        return best
+
+
+def emit_match(out, source, target, s, t, length):
+    """COPY runs of equal bytes, ADD the rest."""
+    end = t + length
+    while t < end:
+        run = 0
+        while t + run < end and source[s + run] == target[t + run]:
+            run += 1
+        if run >= MIN_COPY or t + run == end:
+            out += op(COPY, run)
+            s += run
+            t += run
+            continue
+        # Up to the next run worth a COPY, short equal runs included
+        n = run + 1
+        while t + n < end and source[s + n:s + n + MIN_COPY] != target[t + n:t + n + MIN_COPY]:
+            n += 1
+        out += op(ADD, n)
+        out += bytes((target[t + i] - source[s + i]) & 0xff for i in range(n))
+        s += n
+        t += n
+
+
+def diff(source, target):
+    index = index_source(source)
+    history = History(target)
+    out = bytearray()
+    literal = bytearray()
+    source_pos = 0
+    t = 0
+
+    while t < len(target):
+        seed = target[t:t + SEED]
+        candidates = []
+        # Continuing where the last match ended needs no SEEK
+        if source[source_pos:source_pos + SEED] == seed:
+            candidates.append(source_pos)
+        hit = index.get(seed) if len(seed) == SEED else None
+        if hit is not None and hit != source_pos:
+            candidates.append(hit)
+
+        best = None
+        for s in candidates:
+            length, score = extend(source, target, s, t)
+            if length < SEED:
+                continue
+            score -= len(op(COPY, length)) + (len(varint(zigzag(s - source_pos))) if s != source_pos else 0)
+            if best is None or score > best[0]:
+                best = (score, s, length)
+
+        match = history.find(t)
+        if match is not None and (best is None or match[0] > best[0]):
+            best = None
+        else:
+            match = None
+
+        if best is None and (match is None or match[0] <= 0):
+            literal.append(target[t])
+            t += 1
+            continue
+
+        if literal:
+            out += op(INSERT, len(literal)) + literal
+            literal = bytearray()
+
+        if match is not None:
+            _, distance, length = match
+            out += op(MATCH, length) + varint(distance)
+            t += length
+            continue
+
+        _, s, length = best
+        if s != source_pos:
+            out += op(SEEK, zigzag(s - source_pos))
+        emit_match(out, source, target, s, t, length)
+        source_pos = s + length
+        t += length
+
+    if literal:
+        out += op(INSERT, len(literal)) + literal
+
+    header = HEADER.pack(MAGIC, len(source), len(target), 0, hashlib.sha256(source).digest(),
+                         hashlib.sha256(target).digest())
+    return header + out
+
+
+def read_varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        shift += 7
+        if byte < 0x80:
+            return value, pos
+
+
+def apply(source, patch):
+    magic, source_size, target_size, _, source_hash, target_hash = HEADER.unpack_from(patch)
+    if magic != MAGIC:
+        raise ValueError('not a delta patch')
+    if source_size != len(source) or hashlib.sha256(source).digest() != source_hash:
+        raise ValueError('patch was made for a different image')
+
+    out = bytearray()
+    pos = HEADER.size
+    source_pos = 0
+    while pos < len(patch):
+        value, pos = read_varint(patch, pos)
+        kind, n = value & 7, value >> 3
+        if kind == COPY:
+            out += source[source_pos:source_pos + n]
+            source_pos += n
+        elif kind == ADD:
+            out += bytes((source[source_pos + i] + patch[pos + i]) & 0xff for i in range(n))
+            source_pos += n
+            pos += n
+        elif kind == INSERT:
+            out += patch[pos:pos + n]
+            pos += n
+        elif kind == SEEK:
+            source_pos += unzigzag(n)
+        elif kind == MATCH:
+            distance, pos = read_varint(patch, pos)
+            if distance == 0 or distance > len(out):
+                raise ValueError('MATCH before the start of the image')
+            # Byte by byte, a repeat may overlap the bytes it produces
+            for _ in range(n):
+                out.append(out[-distance])
+        else:
+            raise ValueError('unknown operation %d' % kind)
+
+    if len(out) != target_size or hashlib.sha256(out).digest() != target_hash:
+        raise ValueError('rebuilt image does not match the patch')
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Create or check a delta or compressed OTA patch')
+    parser.add_argument('--apply', action='store_true', help='apply a patch instead of creating one')
+    parser.add_argument('--source', help='signed image running on the device, none for a compressed full image')
+    parser.add_argument('input', help='new signed image, or the patch with --apply')
+    parser.add_argument('output', help='patch, or the rebuilt image with --apply')
+    args = parser.parse_args()
+
+    source = b''
+    if args.source:
+        with open(args.source, 'rb') as f:
+            source = f.read()
+    with open(args.input, 'rb') as f:
+        data = f.read()
+
+    if args.apply:
+        result = apply(source, data)
+    else:
+        result = diff(source, data)
+        # Catch encoder bugs here rather than on a device
+        apply(source, result)
+        print('%d byte image, %d byte patch (%.1f%%)' % (len(data), len(result), 100 * len(result) / len(data)))
+
+    with open(args.output, 'wb') as f:
+        f.write(result)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+"""Decode the Samples attribute of the Humid Samples cluster.
+
+Usage: sample_batch.py <hex> [--received EPOCH]
+
+Takes the attribute value as printed by chip-tool (with or without the hex:
+prefix) and prints one CSV line per sample, oldest first: age in seconds at
+the time of the report, temperature in °C and relative humidity in %. See
+src/samples_cluster.h for the encoding.
+
+Pass the time the report was received to also print wall clock times.
+"""
+
+import argparse
+import struct
+import sys
+from datetime import datetime, timezone
+
+from sample_log import Truncated, unzigzag, varint
+
+
+def decode(data):
+    if not data:
+        return []
+    age, pos = varint(data, 0)
+    temperature, humidity = struct.unpack_from('<hH', data, pos)
+    pos += 4
+    samples = [(age, temperature, humidity)]
+    interval = 0
+    # Records run from the newest sample into the past
+    while pos < len(data):
+        try:
+            first, pos = varint(data, pos)
+            if first & 1:
+                interval, pos = varint(data, pos)
+            dh, pos = varint(data, pos)
+        except Truncated:
+            break
+        age += interval
+        temperature += unzigzag(first >> 1)
+        humidity += unzigzag(dh)
+        samples.append((age, temperature, humidity))
+    return samples[::-1]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode the Humid Samples Samples attribute to CSV')
+    parser.add_argument('value', help='attribute value in hex')
+    parser.add_argument('--received', type=float, help='Unix time the report was received')
+    args = parser.parse_args()
+
+    value = args.value
+    if value.startswith('hex:'):
+        value = value[4:]
+
+    print('age_s,temperature_c,humidity_pct,time')
+    for age, temperature, humidity in decode(bytes.fromhex(value)):
+        time = ''
+        if args.received is not None:
+            time = datetime.fromtimestamp(args.received - age, timezone.utc).isoformat(timespec='seconds')
+        print('%d,%.2f,%.2f,%s' % (age, temperature / 100, humidity / 100, time))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""Decode a sample log retrieved through the Diagnostic Logs cluster.
+
+Usage: sample_log.py <log file> [--time-since-boot US --received EPOCH]
+
+Prints one CSV line per sample: boot, uptime in seconds, temperature in °C
+and relative humidity in %. The log is a sequence of 256 byte blocks, see
+src/sample_log.h for the encoding.
+
+Uptimes restart with every boot. Pass the TimeSinceBoot of the
+RetrieveLogsResponse and the time the log was received to also print wall
+clock times for the samples of the current boot.
+"""
+
+import argparse
+import struct
+import sys
+from datetime import datetime, timezone
+
+BLOCK_SIZE = 256
+HEADER = struct.Struct('<IIHHhH')
+MAGIC = 0x534c
+
+
+class Truncated(Exception):
+    pass
+
+
+def varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        if pos >= len(data):
+            raise Truncated()
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        shift += 7
+        if byte < 0x80:
+            return value, pos
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def decode_block(block):
+    sequence, uptime, magic, boot, temperature, humidity = HEADER.unpack_from(block)
+    if magic != MAGIC:
+        return None
+    samples = [(uptime, temperature, humidity)]
+    interval = 0
+    pos = HEADER.size
+    # The rest of a block is left erased after its last record
+    while pos < len(block) and any(b != 0xff for b in block[pos:]):
+        try:
+            first, pos = varint(block, pos)
+            if first & 1:
+                interval, pos = varint(block, pos)
+            dh, pos = varint(block, pos)
+        except Truncated:
+            break
+        uptime += interval
+        temperature += unzigzag(first >> 1)
+        humidity += unzigzag(dh)
+        samples.append((uptime, temperature, humidity))
+    return sequence, boot, samples
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode a retrieved sample log to CSV')
+    parser.add_argument('log', help='log content or file received over BDX')
+    parser.add_argument('--time-since-boot', type=int, help='TimeSinceBoot of the response in µs')
+    parser.add_argument('--received', type=float, help='Unix time the log was received')
+    args = parser.parse_args()
+
+    with open(args.log, 'rb') as f:
+        data = f.read()
+
+    blocks = []
+    for offset in range(0, len(data) - BLOCK_SIZE + 1, BLOCK_SIZE):
+        block = decode_block(data[offset:offset + BLOCK_SIZE])
+        if block:
+            blocks.append(block)
+    blocks.sort()
+
+    # The newest block is from the current boot
+    current_boot = blocks[-1][1] if blocks else None
+    boot_epoch = None
+    if args.time_since_boot is not None and args.received is not None:
+        boot_epoch = args.received - args.time_since_boot / 1e6
+
+    print('boot,uptime_s,temperature_c,humidity_pct,time')
+    for _, boot, samples in blocks:
+        for uptime, temperature, humidity in samples:
+            time = ''
+            if boot_epoch is not None and boot == current_boot:
+                time = datetime.fromtimestamp(boot_epoch + uptime, timezone.utc).isoformat(timespec='seconds')
+            print('%d,%d,%.2f,%.2f,%s' % (boot, uptime, temperature / 100, humidity / 100, time))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
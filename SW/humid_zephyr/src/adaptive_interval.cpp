@@ -0,0 +1,139 @@
+#include "adaptive_interval.h"
+
+#include <zephyr/device.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/retention/retention.h>
+#include <zephyr/sys/util.h>
+
+#include <stdlib.h>
+
+LOG_MODULE_REGISTER(adaptive_interval, CONFIG_CHIP_APP_LOG_LEVEL);
+
+#if CONFIG_APP_MEASUREMENT_ADAPTIVE
+
+namespace {
+
+// Absent in the unit test, the state then only lives in RAM
+const struct device *retention = DEVICE_DT_GET_OR_NULL(DT_NODELABEL(measure_retention));
+
+// A change too small to be reported is never fast
+constexpr int32_t kTemperatureNoise = MAX(CONFIG_APP_ADAPTIVE_TEMP_NOISE, CONFIG_APP_REPORT_TEMP_DELTA);
+constexpr int32_t kHumidityNoise = MAX(CONFIG_APP_ADAPTIVE_HUMIDITY_NOISE, CONFIG_APP_REPORT_HUMIDITY_DELTA);
+
+uint32_t ClampInterval(uint32_t interval_sec)
+{
+	return CLAMP(interval_sec, CONFIG_APP_MEASUREMENT_INTERVAL_MIN_SEC, CONFIG_APP_MEASUREMENT_INTERVAL_MAX_SEC);
+}
+
+// Slope thresholds are in 0.01 units per minute. Steps within the sensor
+// noise say nothing about the slope, at the minimum interval a single LSB
+// or repeatability step would otherwise exceed it.
+bool ChangingFast(int32_t delta, int32_t noise, int32_t slope_per_min, int64_t elapsed_ms)
+{
+	if (abs(delta) <= noise) {
+		return false;
+	}
+
+	return static_cast<int64_t>(abs(delta)) * 60000 > static_cast<int64_t>(slope_per_min) * elapsed_ms;
+}
+
+} // namespace
+
+void AdaptiveInterval::Init()
+{
+	state = {};
+	state.interval_sec = ClampInterval(CONFIG_APP_MEASUREMENT_INTERVAL_SEC);
+
+	if (device_is_ready(retention) && retention_is_valid(retention) == 1 &&
+	    retention_read(retention, 0, reinterpret_cast<uint8_t *>(&state), sizeof(state)) == 0) {
+		state.interval_sec = ClampInterval(state.interval_sec);
+		LOG_INF("Restored measurement interval %u s", state.interval_sec);
+	}
+}
+
+void AdaptiveInterval::Restore(uint32_t interval_sec, int16_t last_temperature, uint16_t last_humidity,
+			       bool has_sample)
+{
+	state.interval_sec = ClampInterval(interval_sec);
+	state.last_temperature = last_temperature;
+	state.last_humidity = last_humidity;
+	state.has_sample = has_sample;
+	Save();
+}
+
+uint32_t AdaptiveInterval::Update(int16_t temperature, uint16_t humidity, int64_t elapsed_ms)
+{
+	// First sample after a reset, the previous one came from retained RAM
+	if (elapsed_ms <= 0) {
+		elapsed_ms = state.interval_sec * 1000LL;
+	}
+
+	if (state.has_sample &&
+	    (ChangingFast(temperature - state.last_temperature, kTemperatureNoise, CONFIG_APP_ADAPTIVE_TEMP_SLOPE,
+			  elapsed_ms) ||
+	     ChangingFast(humidity - state.last_humidity, kHumidityNoise, CONFIG_APP_ADAPTIVE_HUMIDITY_SLOPE,
+			  elapsed_ms))) {
+		if (state.interval_sec != CONFIG_APP_MEASUREMENT_INTERVAL_MIN_SEC) {
+			LOG_INF("Readings changing fast, interval %u -> %u s", state.interval_sec,
+				CONFIG_APP_MEASUREMENT_INTERVAL_MIN_SEC);
+		}
+		state.interval_sec = CONFIG_APP_MEASUREMENT_INTERVAL_MIN_SEC;
+	} else if (state.has_sample) {
+		state.interval_sec = ClampInterval(state.interval_sec * 2);
+	}
+
+	state.last_temperature = temperature;
+	state.last_humidity = humidity;
+	state.has_sample = 1;
+	Save();
+
+	return state.interval_sec;
+}
+
+bool AdaptiveInterval::Stable() const
+{
+	return state.has_sample && state.interval_sec > CONFIG_APP_MEASUREMENT_INTERVAL_MIN_SEC;
+}
+
+void AdaptiveInterval::Save()
+{
+	if (!device_is_ready(retention)) {
+		return;
+	}
+
+	int rc = retention_write(retention, 0, reinterpret_cast<const uint8_t *>(&state), sizeof(state));
+	if (rc != 0) {
+		LOG_ERR("Failed to save interval to retained RAM: %d", rc);
+	}
+}
+
+#else
+
+void AdaptiveInterval::Init()
+{
+	state = {};
+	state.interval_sec = CONFIG_APP_MEASUREMENT_INTERVAL_SEC;
+}
+
+void AdaptiveInterval::Restore(uint32_t interval_sec, int16_t last_temperature, uint16_t last_humidity,
+			       bool has_sample)
+{
+	state.last_temperature = last_temperature;
+	state.last_humidity = last_humidity;
+	state.has_sample = has_sample;
+}
+
+uint32_t AdaptiveInterval::Update(int16_t temperature, uint16_t humidity, int64_t elapsed_ms)
+{
+	state.has_sample = 1;
+	return state.interval_sec;
+}
+
+bool AdaptiveInterval::Stable() const
+{
+	return state.has_sample;
+}
+
+void AdaptiveInterval::Save() {}
+
+#endif // CONFIG_APP_MEASUREMENT_ADAPTIVE
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+
+// Measurement interval that follows how fast readings are changing.
+//
+// When temperature or humidity moves faster than the configured slope the
+// interval drops to CONFIG_APP_MEASUREMENT_INTERVAL_MIN_SEC, to catch events like
+// a shower or a leak. While readings are flat it doubles on every sample, up to
+// CONFIG_APP_MEASUREMENT_INTERVAL_MAX_SEC.
+//
+// State is kept in retained RAM so it survives System OFF and warm resets.
+class AdaptiveInterval {
+public:
+	void Init();
+
+	// Feed a new sample, elapsed_ms is the time since the previous one.
+	// Returns the interval to wait before the next measurement.
+	uint32_t Update(int16_t temperature, uint16_t humidity, int64_t elapsed_ms);
+
+	uint32_t IntervalSec() const { return state.interval_sec; }
+
+	// True once readings have been flat for at least one interval
+	bool Stable() const;
+
+	// Previous sample, for checkpointing
+	bool HasSample() const { return state.has_sample; }
+	int16_t LastTemperature() const { return state.last_temperature; }
+	uint16_t LastHumidity() const { return state.last_humidity; }
+
+	// Resume from a checkpoint after a supply loss
+	void Restore(uint32_t interval_sec, int16_t last_temperature, uint16_t last_humidity, bool has_sample);
+
+private:
+	void Save();
+
+	struct State {
+		uint32_t interval_sec;
+		int16_t last_temperature;
+		uint16_t last_humidity;
+		uint8_t has_sample;
+	} state;
+};
@@ -1,11 +1,29 @@
 #include "app_task.h"
+#include "battery.h"
+#include "checkpoint.h"
+#include "diagnostics_cluster.h"
+#include "energy_budget.h"
+#include "flash_power.h"
+#include "footprint.h"
+#include "kvs_cache.h"
+#include "leak_sensor.h"
+#include "measure_pipeline.h"
+#include "measure_scheduler.h"
+#include "ota_image_processor.h"
+#include "ota_requestor_driver.h"
+#include "sample_log.h"
+#include "samples_cluster.h"
+#include "sensor_bench.h"
 #include "sht4x.h"
+#include "thread_csl.h"
+#include "trace.h"
+#include "tx_power.h"
+#include "wake_report.h"
 
 #include <app/server/Server.h>
 #include <app/clusters/network-commissioning/network-commissioning.h>
 #include <app/clusters/ota-requestor/BDXDownloader.h>
 #include <app/clusters/ota-requestor/DefaultOTARequestor.h>
-#include <app/clusters/ota-requestor/DefaultOTARequestorDriver.h>
 #include <app/clusters/ota-requestor/DefaultOTARequestorStorage.h>
 #include <app/clusters/ota-requestor/OTARequestorInterface.h>
 #include <app/reporting/reporting.h>
@@ -18,7 +36,6 @@
 #include <lib/core/CHIPError.h>
 #include <lib/support/CodeUtils.h>
 #include <platform/CHIPDeviceLayer.h>
-#include <platform/nrfconnect/OTAImageProcessorImpl.h>
 #include <platform/OpenThread/GenericNetworkCommissioningThreadDriver.h>
 #include <platform/ThreadStackManager.h>
 
@@ -38,14 +55,100 @@ namespace {
 chip::app::Clusters::NetworkCommissioning::InstanceAndDriver<
 	chip::DeviceLayer::NetworkCommissioning::GenericThreadDriver> THREAD_NETWORK_DRIVER(0);
 
+EnergyBudget energy_budget;
+FlashPower flash_power;
+
 // OTA Requestor
 chip::DefaultOTARequestorStorage sOTARequestorStorage;
-chip::DeviceLayer::DefaultOTARequestorDriver sOTARequestorDriver;
+AppOTARequestorDriver sOTARequestorDriver(energy_budget);
 chip::BDXDownloader sBDXDownloader;
 chip::DefaultOTARequestor sOTARequestor;
 
-struct k_work_delayable measure_work;
+KvsCache kvs_cache;
+WakeReport wake_report;
+ThreadCsl thread_csl;
+TxPower tx_power;
+
+MeasureScheduler measure_scheduler;
+DiagnosticsCluster diagnostics_cluster;
 Sht4x sht4x;
+Battery battery;
+Checkpoint checkpoint;
+LeakSensor leak_sensor;
+SampleLog sample_log;
+SamplesCluster samples_cluster;
+MeasurePipeline measure_pipeline(sht4x);
+
+// Endpoint 1 measurement clusters
+class MeasurementClusters : public AttributeSink {
+public:
+	void SetTemperature(int16_t temperature) override
+	{
+		chip::app::Clusters::TemperatureMeasurement::Attributes::MeasuredValue::Set(
+			1, chip::app::DataModel::Nullable<int16_t>(temperature));
+	}
+
+	void SetHumidity(uint16_t humidity) override
+	{
+		chip::app::Clusters::RelativeHumidityMeasurement::Attributes::MeasuredValue::Set(
+			1, chip::app::DataModel::Nullable<uint16_t>(humidity));
+	}
+
+	// Null indicates the sensor is unavailable
+	void SetNull() override
+	{
+		chip::app::Clusters::TemperatureMeasurement::Attributes::MeasuredValue::Set(
+			1, chip::app::DataModel::Nullable<int16_t>());
+		chip::app::Clusters::RelativeHumidityMeasurement::Attributes::MeasuredValue::Set(
+			1, chip::app::DataModel::Nullable<uint16_t>());
+	}
+};
+
+MeasurementClusters measurement_clusters;
+
+Checkpoint::State CheckpointState()
+{
+	Checkpoint::State state = {};
+
+	measure_scheduler.SaveCheckpoint(state);
+	measure_pipeline.SaveCheckpoint(state);
+
+	return state;
+}
+
+void RestoreCheckpoint()
+{
+	Checkpoint::State state;
+
+	// Only after a brown-out or power loss, with the checkpoint written right before it
+	if (!checkpoint.Latest(state)) {
+		return;
+	}
+
+	measure_scheduler.RestoreCheckpoint(state);
+	measure_pipeline.RestoreCheckpoint(state);
+}
+
+void UpdatePowerSource()
+{
+	using namespace chip::app::Clusters::PowerSource;
+
+	uint8_t percent = battery.Percent();
+	BatChargeLevelEnum charge_level = BatChargeLevelEnum::kOk;
+
+	if (percent <= CONFIG_APP_BATTERY_CRITICAL_PERCENT) {
+		charge_level = BatChargeLevelEnum::kCritical;
+	} else if (percent <= CONFIG_APP_BATTERY_WARNING_PERCENT) {
+		charge_level = BatChargeLevelEnum::kWarning;
+	}
+
+	Attributes::BatPresent::Set(kRootEndpointId, true);
+	Attributes::BatVoltage::Set(kRootEndpointId, chip::app::DataModel::Nullable<uint32_t>(battery.VoltageMv()));
+	// In half percent units
+	Attributes::BatPercentRemaining::Set(kRootEndpointId, chip::app::DataModel::Nullable<uint8_t>(percent * 2));
+	Attributes::BatChargeLevel::Set(kRootEndpointId, charge_level);
+	Attributes::BatReplacementNeeded::Set(kRootEndpointId, charge_level == BatChargeLevelEnum::kCritical);
+}
 
 void LockOpenThreadTask()
 {
@@ -63,36 +166,43 @@ void AppTask::MeasureWorkPeriodic(struct k_work *work)
 {
 	int16_t temperature;
 	uint16_t humidity;
-	bool success = false;
-	if (sht4x.Ready()) {
 
-		// Read SHT4x sensor
-		success = sht4x.Read(temperature, humidity);
-	} else {
-		LOG_DBG("Sht4x not ready");
-	}
+	// Decide what this wake can afford before spending energy on it
+	PowerPolicy::Level supply_level = energy_budget.Sample();
+
+	// Read SHT4x sensor
+	bool success = measure_pipeline.Read(temperature, humidity, measure_scheduler.SignalStable(),
+					     energy_budget.Plentiful());
+
+	// Battery voltage changes slowly, only sampled every CONFIG_APP_BATTERY_INTERVAL_SEC
+	bool battery_sampled = battery.Ready() && battery.Sample();
 
 	// Update Matter attributes
 	PlatformMgr().LockChipStack();
+	if (battery_sampled) {
+		UpdatePowerSource();
+		measure_scheduler.OnBatterySampled(battery.Percent());
+	}
+	measure_scheduler.OnSupplySampled(supply_level);
+	sOTARequestorDriver.OnEnergySampled();
+
+	TraceBegin(TracePhase::kAttributeSet);
+	measure_pipeline.Report(success, temperature, humidity, measurement_clusters);
 	if (success) {
-		chip::app::Clusters::TemperatureMeasurement::Attributes::MeasuredValue::Set(
-			1, chip::app::DataModel::Nullable<int16_t>(temperature));
-		chip::app::Clusters::RelativeHumidityMeasurement::Attributes::MeasuredValue::Set(
-			1, chip::app::DataModel::Nullable<uint16_t>(humidity));
-	} else {
-		// Set to null on error to indicate sensor unavailable
-		chip::app::Clusters::TemperatureMeasurement::Attributes::MeasuredValue::Set(
-			1, chip::app::DataModel::Nullable<int16_t>());
-		chip::app::Clusters::RelativeHumidityMeasurement::Attributes::MeasuredValue::Set(
-			1, chip::app::DataModel::Nullable<uint16_t>());
+		sample_log.Append(temperature, humidity);
+		samples_cluster.Add(temperature, humidity);
 	}
-	PlatformMgr().UnlockChipStack();
+	TraceEnd(TracePhase::kAttributeSet);
 
-	k_work_schedule(&measure_work, K_SECONDS(CONFIG_APP_MEASUREMENT_INTERVAL_SEC));
+	measure_scheduler.OnMeasured(success, temperature, humidity);
+	checkpoint.Stage(CheckpointState());
+	PlatformMgr().UnlockChipStack();
 }
 
 CHIP_ERROR AppTask::Init()
 {
+	AppOTAImageProcessor::ReportBootTime();
+
 	ReturnErrorOnFailure(PlatformMgr().InitChipStack());
 
 	ReturnErrorOnFailure(ThreadStackMgr().InitThreadStack());
@@ -111,29 +221,53 @@ CHIP_ERROR AppTask::Init()
 	initParams.endpointNativeParams = static_cast<void *>(&nativeParams);
 
 	ReturnErrorOnFailure(initParams.InitializeStaticResourcesBeforeServerInit());
+	ReturnErrorOnFailure(kvs_cache.Init(initParams));
 
 	initParams.dataModelProvider = chip::app::CodegenDataModelProviderInstance(initParams.persistentStorageDelegate);
 
+	TraceBegin(TracePhase::kChipInit);
 	ReturnErrorOnFailure(chip::Server::GetInstance().Init(initParams));
+	TraceEnd(TracePhase::kChipInit);
+	ReturnErrorOnFailure(FootprintInit());
+	ReturnErrorOnFailure(kvs_cache.Attach());
+	ReturnErrorOnFailure(wake_report.Init());
+	ReturnErrorOnFailure(thread_csl.Init());
+	ReturnErrorOnFailure(tx_power.Init());
 
 	ConfigurationMgr().LogDeviceConfig();
 
 	// Initialize OTA Requestor
-	static chip::DeviceLayer::OTAImageProcessorImpl sOTAImageProcessor;
+	static AppOTAImageProcessor sOTAImageProcessor(&flash_power);
 	sOTAImageProcessor.SetOTADownloader(&sBDXDownloader);
 	sBDXDownloader.SetImageProcessorDelegate(&sOTAImageProcessor);
 	sOTARequestorStorage.Init(chip::Server::GetInstance().GetPersistentStorage());
 	sOTARequestor.Init(chip::Server::GetInstance(), sOTARequestorStorage, sOTARequestorDriver, sBDXDownloader);
 	sOTARequestorDriver.Init(&sOTARequestor, &sOTAImageProcessor);
 	chip::SetRequestorInstance(&sOTARequestor);
+	ReturnErrorOnFailure(flash_power.Init());
 
 	// Initialize SHT4x driver
+	TraceBegin(TracePhase::kSensorInit);
 	ReturnErrorOnFailure(sht4x.Init());
+	TraceEnd(TracePhase::kSensorInit);
+	SensorBenchInit(sht4x);
+
+	ReturnErrorOnFailure(battery.Init());
+
+	ReturnErrorOnFailure(leak_sensor.Init());
+
+	ReturnErrorOnFailure(energy_budget.Init());
+
+	ReturnErrorOnFailure(checkpoint.Init());
+
+	ReturnErrorOnFailure(sample_log.Init());
+
+	// Start periodic measurements, once commissioned
+	ReturnErrorOnFailure(measure_scheduler.Init(AppTask::MeasureWorkPeriodic));
+	RestoreCheckpoint();
 
-	// Start measurement periodic after short delay
-	// TODO only start once commissioned
-	k_work_init_delayable(&measure_work, AppTask::MeasureWorkPeriodic);
-	k_work_schedule(&measure_work, K_MSEC(500));
+	ReturnErrorOnFailure(diagnostics_cluster.Init(measure_scheduler, sht4x, kvs_cache, tx_power));
+	ReturnErrorOnFailure(samples_cluster.Init());
 
 	return CHIP_NO_ERROR;
 }
@@ -141,6 +275,7 @@ CHIP_ERROR AppTask::Init()
 CHIP_ERROR AppTask::StartApp()
 {
 	ReturnErrorOnFailure(Init());
+	TraceEnd(TracePhase::kBoot);
 
 	LOG_INF("Matter server initialized");
 
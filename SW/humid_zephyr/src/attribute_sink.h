@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+// Where MeasurePipeline::Report() writes the measured values: the Matter
+// measurement clusters on target, a loopback store in the native_sim build
+class AttributeSink {
+public:
+	virtual ~AttributeSink() = default;
+
+	virtual void SetTemperature(int16_t temperature) = 0;
+	virtual void SetHumidity(uint16_t humidity) = 0;
+
+	// Both values null, the sensor is unavailable
+	virtual void SetNull() = 0;
+};
@@ -0,0 +1,107 @@
+#include "battery.h"
+
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/dt-bindings/adc/nrf-saadc.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_REGISTER(battery, CONFIG_CHIP_APP_LOG_LEVEL);
+
+#if DT_HAS_COMPAT_STATUS_OKAY(nordic_npm1300_charger)
+#define BATTERY_NODE DT_COMPAT_GET_ANY_STATUS_OKAY(nordic_npm1300_charger)
+#define BATTERY_CHANNEL SENSOR_CHAN_GAUGE_VOLTAGE
+#elif DT_NODE_HAS_STATUS_OKAY(DT_NODELABEL(vbatt))
+#define BATTERY_NODE DT_NODELABEL(vbatt)
+#define BATTERY_CHANNEL SENSOR_CHAN_VOLTAGE
+
+#if DT_NODE_HAS_STATUS_OKAY(DT_NODELABEL(uart20))
+#define VBATT_INPUT                                                                                           \
+	DT_PROP(DT_CHILD_BY_UNIT_ADDR_INT(DT_IO_CHANNELS_CTLR(BATTERY_NODE), DT_IO_CHANNELS_INPUT(BATTERY_NODE)), \
+		zephyr_input_positive)
+// The divider would load the console lines and read them instead of the battery
+BUILD_ASSERT(VBATT_INPUT < NRF_SAADC_AIN0 || VBATT_INPUT > NRF_SAADC_AIN3,
+	     "vbatt is on AIN0-3 (P1.04-P1.07), the UART20 console pins");
+#endif
+#else
+#error "No nordic,npm1300-charger or vbatt node found in the device tree"
+#endif
+
+namespace {
+
+struct DischargePoint {
+	uint16_t voltage_mv;
+	uint8_t percent;
+};
+
+// Typical Li-ion discharge curve at low load, highest voltage first
+constexpr DischargePoint kDischargeCurve[] = {
+	{4200, 100}, {4060, 90}, {3980, 80}, {3920, 70}, {3870, 60}, {3820, 50},
+	{3790, 40},  {3770, 30}, {3740, 20}, {3680, 10}, {3450, 5},  {3000, 0},
+};
+
+uint8_t PercentFromVoltage(uint32_t voltage_mv)
+{
+	if (voltage_mv >= kDischargeCurve[0].voltage_mv) {
+		return 100;
+	}
+
+	for (size_t i = 1; i < ARRAY_SIZE(kDischargeCurve); i++) {
+		const DischargePoint &high = kDischargeCurve[i - 1];
+		const DischargePoint &low = kDischargeCurve[i];
+
+		if (voltage_mv >= low.voltage_mv) {
+			return low.percent + (voltage_mv - low.voltage_mv) * (high.percent - low.percent) /
+						     (high.voltage_mv - low.voltage_mv);
+		}
+	}
+
+	return 0;
+}
+
+} // namespace
+
+CHIP_ERROR Battery::Init()
+{
+	dev = DEVICE_DT_GET(BATTERY_NODE);
+
+	if (!device_is_ready(dev)) {
+		LOG_ERR("Battery monitor not ready");
+	}
+
+	return CHIP_NO_ERROR;
+}
+
+bool Battery::Ready()
+{
+	return device_is_ready(dev);
+}
+
+bool Battery::Sample()
+{
+	int64_t now = k_uptime_get();
+	struct sensor_value value;
+	int rc;
+
+	if (sampled && now - last_sample_ms < CONFIG_APP_BATTERY_INTERVAL_SEC * 1000LL) {
+		return false;
+	}
+
+	rc = sensor_sample_fetch(dev);
+	if (rc == 0) {
+		rc = sensor_channel_get(dev, BATTERY_CHANNEL, &value);
+	}
+	if (rc != 0) {
+		LOG_ERR("Failed to read battery voltage: %d", rc);
+		return false;
+	}
+
+	last_sample_ms = now;
+	sampled = true;
+	voltage_mv = MAX(sensor_value_to_milli(&value), 0);
+	percent = PercentFromVoltage(voltage_mv);
+
+	LOG_INF("Battery: %u mV, %u%%", voltage_mv, percent);
+
+	return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include <stdint.h>
+
+// Battery voltage and state of charge.
+//
+// Reads the battery voltage from the nPM1300 charger when one is in the
+// devicetree, otherwise from the vbatt voltage divider on the SAADC. The
+// percentage comes from a Li-ion discharge curve.
+//
+// Sampling is cheap but the voltage changes slowly, so Sample only reads the
+// battery every CONFIG_APP_BATTERY_INTERVAL_SEC and is meant to piggyback on
+// the periodic measurement instead of waking up on its own.
+class Battery {
+public:
+	CHIP_ERROR Init();
+
+	bool Ready();
+
+	// Read the battery if the last reading is older than the battery interval.
+	// Returns true when a new reading was taken.
+	bool Sample();
+
+	uint32_t VoltageMv() const { return voltage_mv; }
+	uint8_t Percent() const { return percent; }
+
+private:
+	const struct device *dev;
+	int64_t last_sample_ms = 0;
+	bool sampled = false;
+
+	uint32_t voltage_mv = 0;
+	uint8_t percent = 0;
+};
@@ -0,0 +1,112 @@
+#include "boot_resume.h"
+
+#if CONFIG_APP_BOOT_FAST_RESUME
+
+#include "boot_resume_layout.h"
+
+#include <pm_config.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#if CONFIG_NRF_GRTC_TIMER
+#include <zephyr/drivers/timer/nrf_grtc_timer.h>
+#endif
+
+#include <string.h>
+
+LOG_MODULE_REGISTER(boot_resume, CONFIG_CHIP_APP_LOG_LEVEL);
+
+namespace {
+
+constexpr uint32_t kImageMagic = 0x96f3b83d;
+
+// Start of the MCUboot image header
+struct ImageHeader {
+	uint32_t magic;
+	uint32_t load_addr;
+	uint16_t hdr_size;
+	uint16_t protect_tlv_size;
+	uint32_t img_size;
+};
+
+static_assert(sizeof(boot_resume) <= DT_REG_SIZE(BOOT_RESUME_NODE), "Handshake does not fit boot_resume_ram");
+
+boot_resume *const state = reinterpret_cast<boot_resume *>(BOOT_RESUME_ADDR);
+
+uint32_t Now()
+{
+#if CONFIG_NRF_GRTC_TIMER
+	return static_cast<uint32_t>(z_nrf_grtc_timer_read());
+#else
+	return static_cast<uint32_t>(k_cyc_to_us_floor64(k_cycle_get_64()));
+#endif
+}
+
+// Slot this code runs from, RRAM is memory mapped at its flash offset
+uintptr_t RunningSlot()
+{
+#if CONFIG_MCUBOOT_BOOTLOADER_MODE_DIRECT_XIP || CONFIG_MCUBOOT_BOOTLOADER_MODE_DIRECT_XIP_WITH_REVERT
+	uintptr_t here = reinterpret_cast<uintptr_t>(&RunningSlot);
+
+	if (here >= PM_MCUBOOT_SECONDARY_ADDRESS && here < PM_MCUBOOT_SECONDARY_ADDRESS + PM_MCUBOOT_SECONDARY_SIZE) {
+		return PM_MCUBOOT_SECONDARY_ADDRESS;
+	}
+#endif
+	return PM_MCUBOOT_PRIMARY_ADDRESS;
+}
+
+void Arm()
+{
+	uintptr_t slot = RunningSlot();
+	const ImageHeader *header = reinterpret_cast<const ImageHeader *>(slot);
+
+	if (header->magic != kImageMagic) {
+		LOG_ERR("No image header at 0x%lx, fast resume stays off", static_cast<unsigned long>(slot));
+		return;
+	}
+
+	uint32_t offset = boot_resume_fingerprint_offset(header->hdr_size, header->img_size, header->protect_tlv_size);
+
+	state->slot_offset = slot;
+	memcpy(state->fingerprint, reinterpret_cast<const uint8_t *>(slot + offset), sizeof(state->fingerprint));
+	state->fast_left = CONFIG_APP_BOOT_FAST_RESUME_WAKES;
+	state->armed = 1;
+}
+
+} // namespace
+
+void BootResumeInit()
+{
+	uint32_t now = Now();
+
+	if (state->magic != BOOT_RESUME_MAGIC) {
+		memset(state, 0, sizeof(*state));
+		state->magic = BOOT_RESUME_MAGIC;
+	}
+
+	uint32_t mode = state->mode;
+	uint32_t elapsed_us = now - state->decided_us;
+
+	// Only a boot MCUboot decided on sets it again
+	state->mode = BOOT_RESUME_NONE;
+
+	if (mode == BOOT_RESUME_FAST) {
+		state->fast_us = elapsed_us;
+		LOG_INF("Fast resume: %u us from MCUboot to main, %u wakes until full validation", elapsed_us,
+			state->fast_left);
+		// The image was not checked, it stays armed as it was
+		return;
+	}
+
+	if (mode == BOOT_RESUME_FULL) {
+		state->full_us = elapsed_us;
+		LOG_INF("Full validation: %u us from MCUboot to main, fast resume took %u us", elapsed_us,
+			state->fast_us);
+	}
+
+	// MCUboot validated this image, or it was not armed
+	Arm();
+}
+
+#endif // CONFIG_APP_BOOT_FAST_RESUME
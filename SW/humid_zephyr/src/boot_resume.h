@@ -0,0 +1,25 @@
+#pragma once
+
+// Fast resume from System OFF. Every wake from System OFF is a reset, and
+// MCUboot would hash and check the signature of the whole app image before
+// starting it again. After the image passed a full validation, the app arms
+// a handshake in retained RAM with the slot and a fingerprint of the image.
+// On a wake from System OFF by the GRTC or a GPIO, the MCUboot hook in
+// mcuboot_hooks/ starts the armed image without validating it, as long as
+// the slot still holds the same image.
+//
+// Every other reset validates in full: power on, pin and watchdog resets,
+// the reset after an OTA apply, and a new image in either slot, which has
+// a different fingerprint. Once CONFIG_APP_BOOT_FAST_RESUME_WAKES wakes went
+// the fast way, the next one is validated in full too. The Matter stack
+// clears the reset reason on every boot, so MCUboot only ever sees the
+// cause of the latest reset.
+//
+// The time from MCUboot's decision to main() is logged in both modes.
+
+#if CONFIG_APP_BOOT_FAST_RESUME
+// Call first thing in main(), reports how this boot went and arms the next
+void BootResumeInit();
+#else
+inline void BootResumeInit() {}
+#endif // CONFIG_APP_BOOT_FAST_RESUME
@@ -0,0 +1,51 @@
+#pragma once
+
+// Retained RAM handshake between the app and the MCUboot image check hook
+// in mcuboot_hooks/, shared by both builds. See boot_resume.h.
+
+#include <zephyr/devicetree.h>
+
+#include <stdint.h>
+
+#define BOOT_RESUME_NODE DT_NODELABEL(boot_resume_ram)
+#define BOOT_RESUME_ADDR (DT_REG_ADDR(DT_NODELABEL(retained_sram)) + DT_REG_ADDR(BOOT_RESUME_NODE))
+
+#define BOOT_RESUME_MAGIC 0x42525331 /* "BRS1" */
+
+// Identifies an image without hashing it: the start of the unprotected TLV
+// area, after the 4 byte TLV info, which begins with the image hash TLV.
+// It is at ih_hdr_size + ih_img_size + ih_protect_tlv_size + 4 in the slot.
+#define BOOT_RESUME_FINGERPRINT_SIZE 16
+
+static inline uint32_t boot_resume_fingerprint_offset(uint16_t hdr_size, uint32_t img_size, uint16_t protect_tlv_size)
+{
+	return hdr_size + img_size + protect_tlv_size + 4;
+}
+
+enum boot_resume_mode {
+	BOOT_RESUME_NONE, // MCUboot did not check the armed image
+	BOOT_RESUME_FAST, // validation skipped
+	BOOT_RESUME_FULL, // validated in full
+};
+
+struct boot_resume {
+	uint32_t magic;
+
+	// Set by the app once its image passed a full validation, cleared by
+	// MCUboot whenever it validates that image in full
+	uint32_t armed;
+	// System OFF wakes left before the next full validation
+	uint32_t fast_left;
+	// Flash offset of the slot holding the armed image, and its fingerprint
+	uint32_t slot_offset;
+	uint8_t fingerprint[BOOT_RESUME_FINGERPRINT_SIZE];
+
+	// Written by MCUboot: how it let this boot through, and when it decided,
+	// in us of the GRTC, which keeps counting through System OFF and resets
+	uint32_t mode;
+	uint32_t decided_us;
+
+	// Written by the app: last time from the decision to main() in each mode
+	uint32_t fast_us;
+	uint32_t full_us;
+};
@@ -0,0 +1,246 @@
+#include "checkpoint.h"
+#include "reset_cause.h"
+#include "storage_layout.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(checkpoint, CONFIG_CHIP_APP_LOG_LEVEL);
+
+#if CONFIG_APP_BROWNOUT_CHECKPOINT
+
+#include <pm_config.h>
+
+#ifndef PM_CHECKPOINT_STORAGE_ID
+#error "No checkpoint_storage partition, build with -DFILE_SUFFIX=harvest"
+#endif
+
+#include <hal/nrf_rramc.h>
+#include <zephyr/drivers/comparator.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/hwinfo.h>
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/barrier.h>
+#include <zephyr/sys/crc.h>
+
+#include <stddef.h>
+#include <string.h>
+
+namespace {
+
+struct Record {
+	uint32_t sequence;
+	Checkpoint::State state;
+	// Set on the copy a boot writes once it found the record
+	uint32_t consumed;
+	uint32_t reserved[2];
+	uint32_t crc;
+};
+
+static_assert(sizeof(Record) == 32, "Checkpoint record must stay a whole number of RRAM words");
+
+// The storage layout version sits behind the last slot
+constexpr size_t kSlotCount = (PM_CHECKPOINT_STORAGE_SIZE - kStorageLayoutMarkerSize) / sizeof(Record);
+
+// RRAM is memory mapped, a slot is written with plain stores once RRAMC is in write mode
+Record *const slots = reinterpret_cast<Record *>(PM_CHECKPOINT_STORAGE_ADDRESS);
+
+// Encoded ahead of time so the interrupt only copies it
+Record staged;
+bool staged_valid;
+bool written;
+
+Record latest;
+bool latest_valid;
+bool restorable;
+
+const struct gpio_dt_spec vbat_ok = GPIO_DT_SPEC_GET(DT_PATH(zephyr_user), vbat_ok_gpios);
+struct gpio_callback vbat_ok_cb;
+
+uint32_t RecordCrc(const Record &record)
+{
+	return crc32_ieee(reinterpret_cast<const uint8_t *>(&record), offsetof(Record, crc));
+}
+
+bool RecordValid(const Record &record)
+{
+	return record.sequence != UINT32_MAX && record.crc == RecordCrc(record);
+}
+
+bool SupplyLost()
+{
+	uint32_t reset_cause = ResetCause();
+
+	return reset_cause == 0 || (reset_cause & (RESET_POR | RESET_BROWNOUT)) != 0;
+}
+
+// Writes a consumed copy of latest to the next slot, through the flash
+// driver since the interrupt is not armed yet
+void Consume()
+{
+	const struct flash_area *area;
+	Record record = latest;
+
+	record.sequence = latest.sequence + 1;
+	record.consumed = 1;
+	record.crc = RecordCrc(record);
+
+	if (flash_area_open(PM_CHECKPOINT_STORAGE_ID, &area) != 0) {
+		LOG_ERR("Failed to open checkpoint storage");
+		return;
+	}
+
+	if (flash_area_write(area, (record.sequence % kSlotCount) * sizeof(Record), &record, sizeof(record)) == 0) {
+		latest = record;
+	} else {
+		LOG_ERR("Failed to consume checkpoint %u", latest.sequence);
+	}
+
+	flash_area_close(area);
+}
+
+void RetryExpired(struct k_timer *timer);
+
+// The interrupt may land in the middle of a flash driver write, try again
+// shortly instead of waiting for it
+K_TIMER_DEFINE(retry_timer, RetryExpired, nullptr);
+
+// Runs from interrupt context, bounded to one 32 byte unbuffered RRAM write
+void WriteStaged()
+{
+	// Only the first trigger per staged state is written, a dip the supply
+	// recovers from is followed by a new Stage() that re-arms it
+	if (!staged_valid || written) {
+		return;
+	}
+
+	nrf_rramc_config_t previous;
+
+	nrf_rramc_config_get(NRF_RRAMC, &previous);
+
+	// The flash driver is between enabling write mode and finishing its
+	// write, don't interfere with it
+	if (previous.mode_write || !nrf_rramc_ready_check(NRF_RRAMC)) {
+		k_timer_start(&retry_timer, K_USEC(100), K_NO_WAIT);
+		return;
+	}
+
+	nrf_rramc_config_t config = previous;
+
+	config.mode_write = true;
+	config.write_buff_size = 0;
+
+	nrf_rramc_config_set(NRF_RRAMC, &config);
+	memcpy(&slots[staged.sequence % kSlotCount], &staged, sizeof(staged));
+	barrier_dmem_fence_full();
+	while (!nrf_rramc_ready_check(NRF_RRAMC)) {
+	}
+	nrf_rramc_config_set(NRF_RRAMC, &previous);
+
+	written = true;
+}
+
+void RetryExpired(struct k_timer *timer)
+{
+	WriteStaged();
+}
+
+void VbatOkFalling(const struct device *port, struct gpio_callback *cb, gpio_port_pins_t pins)
+{
+	WriteStaged();
+}
+
+#if DT_NODE_HAS_STATUS_OKAY(DT_NODELABEL(comp))
+const struct device *comparator = DEVICE_DT_GET(DT_NODELABEL(comp));
+
+void ComparatorFalling(const struct device *dev, void *user_data)
+{
+	WriteStaged();
+}
+#endif
+
+} // namespace
+
+CHIP_ERROR Checkpoint::Init()
+{
+	for (size_t i = 0; i < kSlotCount; i++) {
+		const Record &record = slots[i];
+
+		if (RecordValid(record) && (!latest_valid || record.sequence > latest.sequence)) {
+			latest = record;
+			latest_valid = true;
+		}
+	}
+
+	if (latest_valid && !latest.consumed) {
+		restorable = SupplyLost();
+		LOG_INF("Found checkpoint %u, %s", latest.sequence,
+			restorable ? "resuming after a supply loss" : "not after a supply loss");
+		Consume();
+	}
+
+	staged.sequence = latest_valid ? latest.sequence + 1 : 0;
+
+	if (gpio_is_ready_dt(&vbat_ok) && gpio_pin_configure_dt(&vbat_ok, GPIO_INPUT) == 0 &&
+	    gpio_pin_interrupt_configure_dt(&vbat_ok, GPIO_INT_EDGE_TO_INACTIVE) == 0) {
+		gpio_init_callback(&vbat_ok_cb, VbatOkFalling, BIT(vbat_ok.pin));
+		gpio_add_callback_dt(&vbat_ok, &vbat_ok_cb);
+	} else {
+		LOG_ERR("Failed to arm VBAT_OK interrupt");
+	}
+
+#if DT_NODE_HAS_STATUS_OKAY(DT_NODELABEL(comp))
+	if (!device_is_ready(comparator) ||
+	    comparator_set_trigger_callback(comparator, ComparatorFalling, nullptr) != 0 ||
+	    comparator_set_trigger(comparator, COMPARATOR_TRIGGER_FALLING_EDGE) != 0) {
+		LOG_ERR("Failed to arm VSTOR comparator");
+	}
+#endif
+
+	return CHIP_NO_ERROR;
+}
+
+bool Checkpoint::Latest(State &state) const
+{
+	if (!restorable) {
+		return false;
+	}
+
+	state = latest.state;
+
+	return true;
+}
+
+void Checkpoint::Stage(const State &state)
+{
+	Record record = {};
+
+	record.state = state;
+
+	// The interrupt must never see a half updated record
+	unsigned int key = irq_lock();
+	// A dip the supply recovered from wrote the staged record, this state
+	// goes to the next slot so the next collapse does not leave it stale
+	record.sequence = written ? staged.sequence + 1 : staged.sequence;
+	record.crc = RecordCrc(record);
+	staged = record;
+	staged_valid = true;
+	written = false;
+	irq_unlock(key);
+}
+
+#else
+
+CHIP_ERROR Checkpoint::Init()
+{
+	return CHIP_NO_ERROR;
+}
+
+bool Checkpoint::Latest(State &state) const
+{
+	return false;
+}
+
+void Checkpoint::Stage(const State &state) {}
+
+#endif // CONFIG_APP_BROWNOUT_CHECKPOINT
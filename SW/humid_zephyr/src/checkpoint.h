@@ -0,0 +1,45 @@
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include <stdint.h>
+
+// Brown-out checkpoint for nodes powered from a storage capacitor.
+//
+// When the supply is about to collapse (VBAT_OK falls, or the comparator on
+// the VSTOR divider trips) the last staged state is written to the
+// checkpoint_storage RRAM partition straight from the interrupt, so the next
+// cold boot can resume the schedule instead of starting from scratch.
+//
+// The write is a single pre-encoded 32 byte record, slots are rotated for
+// wear levelling and the newest valid one wins on boot. Each staged state is
+// written at most once, if the supply recovers the next Stage() arms the
+// triggers again. Every boot that
+// finds a checkpoint marks it consumed, so one is only ever restored on the
+// boot right after it was written, and only when that boot follows a
+// brown-out or power loss.
+class Checkpoint {
+public:
+	enum Flags : uint8_t {
+		kHasSample = 1 << 0,
+	};
+
+	struct State {
+		uint32_t interval_sec;
+		int16_t last_temperature;
+		uint16_t last_humidity;
+		uint16_t heater_pulses;
+		uint8_t supply_level;
+		uint8_t flags;
+	};
+
+	// Finds the newest checkpoint, consumes it and arms the brown-out triggers
+	CHIP_ERROR Init();
+
+	// Checkpoint written by the run before a supply collapse, false if this
+	// boot did not follow one or there is none
+	bool Latest(State &state) const;
+
+	// Encode the state that is written on brown-out, called after every measurement
+	void Stage(const State &state);
+};
@@ -4,5 +4,16 @@
 
 #pragma once
 
-// Placeholder for Matter project-specific configurations
-// Most configs are in prj.conf, this file is required but can be minimal
+// Most configs are in prj.conf. The Matter pools and event buffers stay at
+// the SDK defaults until they are sized from FootprintPeaks measured with
+// the worst case check in the README.
+
+#if CONFIG_APP_FOOTPRINT
+// Packet buffer high-water mark for the footprint report
+#define CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS 1
+#endif
+
+// Server::Init registers the report scheduler and the DNS-SD server, the
+// default of 2 leaves no room for the app: MeasureScheduler, KvsCache,
+// ThreadCsl and TxPower
+#define CHIP_CONFIG_ICD_OBSERVERS_POOL_SIZE (2 + 4)
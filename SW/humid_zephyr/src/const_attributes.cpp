@@ -0,0 +1,114 @@
+/*
+ * Attributes that never change, served from flash instead of ember's RAM
+ * attribute store. They are marked External in sensor.zap. Their clusters
+ * either have no attribute access interface or leave these attributes to
+ * ember, which then reads them through emberAfExternalAttributeReadCallback.
+ */
+
+#include <app-common/zap-generated/cluster-enums.h>
+#include <app-common/zap-generated/ids/Attributes.h>
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <app/util/attribute-metadata.h>
+#include <app/util/generic-callbacks.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/TypeTraits.h>
+
+#include "diagnostics_cluster.h"
+#include "leak_sensor.h"
+#include "samples_cluster.h"
+
+#include <string.h>
+
+using namespace ::chip;
+using namespace ::chip::app::Clusters;
+using ::chip::Protocols::InteractionModel::Status;
+
+// Ember keeps integers in native byte order, the table holds them in the
+// low bytes of an int32_t
+static_assert(!CHIP_CONFIG_BIG_ENDIAN_TARGET);
+
+namespace {
+
+constexpr EndpointId kSensorEndpointId = 1;
+
+struct ConstAttribute {
+	EndpointId endpoint;
+	ClusterId cluster;
+	AttributeId attribute;
+	int32_t value;
+	const char *string; // char_string attributes, value is unused
+};
+
+constexpr AttributeId kFeatureMap = Globals::Attributes::FeatureMap::Id;
+constexpr AttributeId kClusterRevision = Globals::Attributes::ClusterRevision::Id;
+
+const ConstAttribute kConstAttributes[] = {
+	{kRootEndpointId, OtaSoftwareUpdateRequestor::Id, kFeatureMap, 0},
+	{kRootEndpointId, OtaSoftwareUpdateRequestor::Id, kClusterRevision, 1},
+
+	{kRootEndpointId, DiagnosticLogs::Id, kFeatureMap, 0},
+	{kRootEndpointId, DiagnosticLogs::Id, kClusterRevision, 1},
+
+	{kRootEndpointId, PowerSource::Id, PowerSource::Attributes::Status::Id,
+	 to_underlying(PowerSource::PowerSourceStatusEnum::kActive)},
+	{kRootEndpointId, PowerSource::Id, PowerSource::Attributes::Order::Id, 0},
+	{kRootEndpointId, PowerSource::Id, PowerSource::Attributes::Description::Id, 0, "Battery"},
+	{kRootEndpointId, PowerSource::Id, PowerSource::Attributes::BatReplaceability::Id,
+	 to_underlying(PowerSource::BatReplaceabilityEnum::kUnspecified)},
+	{kRootEndpointId, PowerSource::Id, kFeatureMap, to_underlying(PowerSource::Feature::kBattery)},
+	{kRootEndpointId, PowerSource::Id, kClusterRevision, 1},
+
+	{kRootEndpointId, HumidDiagnostics::Id, kFeatureMap, 0},
+	{kRootEndpointId, HumidDiagnostics::Id, kClusterRevision, 1},
+
+	// SHT4x specified range, -40 to 125 °C and 0 to 100 %RH
+	{kSensorEndpointId, TemperatureMeasurement::Id, TemperatureMeasurement::Attributes::MinMeasuredValue::Id, -4000},
+	{kSensorEndpointId, TemperatureMeasurement::Id, TemperatureMeasurement::Attributes::MaxMeasuredValue::Id, 12500},
+	{kSensorEndpointId, TemperatureMeasurement::Id, kFeatureMap, 0},
+	{kSensorEndpointId, TemperatureMeasurement::Id, kClusterRevision, 4},
+
+	{kSensorEndpointId, RelativeHumidityMeasurement::Id, RelativeHumidityMeasurement::Attributes::MinMeasuredValue::Id,
+	 0},
+	{kSensorEndpointId, RelativeHumidityMeasurement::Id, RelativeHumidityMeasurement::Attributes::MaxMeasuredValue::Id,
+	 10000},
+	{kSensorEndpointId, RelativeHumidityMeasurement::Id, kFeatureMap, 0},
+	{kSensorEndpointId, RelativeHumidityMeasurement::Id, kClusterRevision, 3},
+
+	{kSensorEndpointId, HumidSamples::Id, HumidSamples::Attributes::BatchInterval::Id,
+	 CONFIG_APP_SAMPLE_BATCH_INTERVAL_SEC},
+	{kSensorEndpointId, HumidSamples::Id, kFeatureMap, 0},
+	{kSensorEndpointId, HumidSamples::Id, kClusterRevision, 1},
+
+	{LeakSensor::kEndpointId, BooleanState::Id, kFeatureMap, 0},
+	{LeakSensor::kEndpointId, BooleanState::Id, kClusterRevision, 1},
+};
+
+} // namespace
+
+Status emberAfExternalAttributeReadCallback(EndpointId endpoint, ClusterId cluster,
+					    const EmberAfAttributeMetadata *metadata, uint8_t *buffer,
+					    uint16_t max_read_length)
+{
+	for (const ConstAttribute &entry : kConstAttributes) {
+		if (entry.endpoint != endpoint || entry.cluster != cluster || entry.attribute != metadata->attributeId) {
+			continue;
+		}
+
+		if (entry.string) {
+			// Length prefixed, like ember stores char_string
+			size_t length = strlen(entry.string);
+
+			VerifyOrReturnValue(length < max_read_length && length < metadata->size, Status::ResourceExhausted);
+			buffer[0] = static_cast<uint8_t>(length);
+			memcpy(buffer + 1, entry.string, length);
+		} else {
+			VerifyOrReturnValue(metadata->size <= sizeof(entry.value) && metadata->size <= max_read_length,
+					    Status::ResourceExhausted);
+			memcpy(buffer, &entry.value, metadata->size);
+		}
+
+		return Status::Success;
+	}
+
+	return Status::Failure;
+}
@@ -0,0 +1,461 @@
+#include "delta_patch.h"
+
+#if CONFIG_APP_OTA_DELTA
+
+#include <dfu/dfu_multi_image.h>
+#include <dfu/dfu_target.h>
+#include <psa/crypto.h>
+
+#include <pm_config.h>
+
+#include <zephyr/logging/log.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+
+#include <errno.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(delta_patch, CONFIG_CHIP_APP_LOG_LEVEL);
+
+namespace {
+
+constexpr uint32_t kMagic = 0x32504448; // "HDP2"
+constexpr size_t kHashSize = 32;
+constexpr uint32_t kImageMagic = 0x96f3b83d; // MCUboot image header
+
+// Output is handed to dfu_target in whole bursts, aligned to the start of
+// the slot. Each burst fills the stream_flash buffer an exact number of
+// times, so everything before the burst being filled is in flash.
+constexpr size_t kBurstSize = 4096;
+
+static_assert(kBurstSize % CONFIG_CHIP_OTA_REQUESTOR_BUFFER_SIZE == 0,
+	      "Bursts must flush the dfu_target buffer completely");
+
+enum Op : uint8_t {
+	kCopy,
+	kAdd,
+	kInsert,
+	kSeek,
+	kMatch,
+};
+
+struct Header {
+	uint32_t magic;
+	uint32_t source_size;
+	uint32_t target_size;
+	uint32_t reserved;
+	uint8_t source_hash[kHashSize];
+	uint8_t target_hash[kHashSize];
+};
+
+enum class State : uint8_t {
+	kHeader,
+	kOp,
+	kDistance,
+	kData,
+	kFailed,
+};
+
+struct Patch {
+	State state;
+	Header header;
+	size_t header_used;
+	bool target_open;
+
+	const uint8_t *source;
+	uint32_t source_pos;
+	uint32_t written;
+	psa_hash_operation_t hash;
+
+	// Slot being written, MATCH reads earlier output back from it
+	const struct flash_area *target_area;
+	uint8_t burst[kBurstSize];
+	size_t burst_used;
+
+	// Operation or distance varint being parsed
+	uint32_t op_value;
+	uint8_t op_shift;
+
+	// ADD or INSERT data still to come, or the length of a MATCH
+	Op data_op;
+	uint32_t data_left;
+};
+
+Patch patch;
+
+// The image this code runs from, RRAM is memory mapped
+const uint8_t *RunningSlot()
+{
+#if CONFIG_MCUBOOT_BOOTLOADER_MODE_DIRECT_XIP || CONFIG_MCUBOOT_BOOTLOADER_MODE_DIRECT_XIP_WITH_REVERT
+	// Either slot may be running, dfu_target writes the other one
+	uintptr_t here = reinterpret_cast<uintptr_t>(&RunningSlot);
+
+	if (here >= PM_MCUBOOT_SECONDARY_ADDRESS && here < PM_MCUBOOT_SECONDARY_ADDRESS + PM_MCUBOOT_SECONDARY_SIZE) {
+		return reinterpret_cast<const uint8_t *>(PM_MCUBOOT_SECONDARY_ADDRESS);
+	}
+#endif
+	return reinterpret_cast<const uint8_t *>(PM_MCUBOOT_PRIMARY_ADDRESS);
+}
+
+// The slot dfu_target writes
+uint8_t TargetSlotId()
+{
+#if CONFIG_MCUBOOT_BOOTLOADER_MODE_DIRECT_XIP || CONFIG_MCUBOOT_BOOTLOADER_MODE_DIRECT_XIP_WITH_REVERT
+	if (RunningSlot() == reinterpret_cast<const uint8_t *>(PM_MCUBOOT_SECONDARY_ADDRESS)) {
+		return PM_MCUBOOT_PRIMARY_ID;
+	}
+#endif
+	return PM_MCUBOOT_SECONDARY_ID;
+}
+
+int32_t UnZigZag(uint32_t value)
+{
+	return static_cast<int32_t>((value >> 1) ^ (0 - (value & 1)));
+}
+
+bool SourceAvailable(uint32_t length)
+{
+	return patch.source_pos <= patch.header.source_size && length <= patch.header.source_size - patch.source_pos;
+}
+
+bool Flush()
+{
+	uint32_t burst_start = patch.written - patch.burst_used;
+
+	if (burst_start == 0 && patch.burst_used >= sizeof(kImageMagic) &&
+	    sys_get_le32(patch.burst) != kImageMagic) {
+		LOG_ERR("Delta patch does not produce an MCUboot image");
+		return false;
+	}
+
+	int ret = dfu_target_write(patch.burst, patch.burst_used);
+
+	if (ret != 0) {
+		LOG_ERR("Failed to write image: %d", ret);
+		return false;
+	}
+
+	patch.burst_used = 0;
+
+	return true;
+}
+
+bool Output(const uint8_t *data, size_t length)
+{
+	if (length > patch.header.target_size - patch.written) {
+		LOG_ERR("Delta patch runs past the target image");
+		return false;
+	}
+
+	if (psa_hash_update(&patch.hash, data, length) != PSA_SUCCESS) {
+		return false;
+	}
+
+	while (length > 0) {
+		size_t n = MIN(length, kBurstSize - patch.burst_used);
+
+		memcpy(patch.burst + patch.burst_used, data, n);
+		patch.burst_used += n;
+		patch.written += n;
+		data += n;
+		length -= n;
+
+		if (patch.burst_used == kBurstSize && !Flush()) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Reads earlier output, from the burst being filled or from flash before it
+bool ReadOutput(uint32_t pos, uint8_t *data, size_t length)
+{
+	uint32_t burst_start = patch.written - patch.burst_used;
+
+	if (pos < burst_start) {
+		size_t n = MIN(length, burst_start - pos);
+		size_t flushed;
+
+		if (dfu_target_offset_get(&flushed) != 0 || pos + n > flushed ||
+		    flash_area_read(patch.target_area, pos, data, n) != 0) {
+			LOG_ERR("Failed to read back the image at %u", pos);
+			return false;
+		}
+		pos += n;
+		data += n;
+		length -= n;
+	}
+
+	memcpy(data, patch.burst + (pos - burst_start), length);
+
+	return true;
+}
+
+bool Match(uint32_t distance, uint32_t length)
+{
+	uint8_t repeat[64];
+
+	if (distance == 0 || distance > patch.written) {
+		LOG_ERR("Delta patch MATCH before the start of the image");
+		return false;
+	}
+
+	while (length > 0) {
+		// No further than distance at a time, a repeat may overlap its own output
+		size_t n = MIN(MIN(length, sizeof(repeat)), distance);
+
+		if (!ReadOutput(patch.written - distance, repeat, n) || !Output(repeat, n)) {
+			return false;
+		}
+		length -= n;
+	}
+
+	return true;
+}
+
+// Checks the header and that the patch was made against the running image
+bool Start()
+{
+	uint8_t hash[kHashSize];
+	size_t hash_length;
+
+	if (patch.header.magic != kMagic || patch.header.source_size > PM_MCUBOOT_PRIMARY_SIZE ||
+	    patch.header.target_size > PM_MCUBOOT_PRIMARY_SIZE) {
+		LOG_ERR("Invalid delta patch header");
+		return false;
+	}
+
+	if (psa_hash_compute(PSA_ALG_SHA_256, patch.source, patch.header.source_size, hash, sizeof(hash),
+			     &hash_length) != PSA_SUCCESS ||
+	    memcmp(hash, patch.header.source_hash, kHashSize) != 0) {
+		LOG_ERR("Delta patch was made for a different image");
+		return false;
+	}
+
+	if (psa_hash_setup(&patch.hash, PSA_ALG_SHA_256) != PSA_SUCCESS) {
+		return false;
+	}
+
+	int ret = flash_area_open(TargetSlotId(), &patch.target_area);
+
+	if (ret != 0) {
+		LOG_ERR("Failed to open target slot: %d", ret);
+		return false;
+	}
+
+	ret = dfu_target_init(DFU_TARGET_IMAGE_TYPE_MCUBOOT, 0, patch.header.target_size, nullptr);
+
+	if (ret != 0) {
+		LOG_ERR("Failed to open image target: %d", ret);
+		return false;
+	}
+
+	patch.target_open = true;
+	if (patch.header.source_size == 0) {
+		LOG_INF("Unpacking compressed %u byte image", patch.header.target_size);
+	} else {
+		LOG_INF("Applying delta patch, %u byte image from %u byte source", patch.header.target_size,
+			patch.header.source_size);
+	}
+
+	return true;
+}
+
+// Adds a byte to the varint being parsed, true once it is complete
+bool VarintByte(uint8_t byte, uint32_t &value)
+{
+	patch.op_value |= static_cast<uint32_t>(byte & 0x7f) << patch.op_shift;
+	patch.op_shift += 7;
+
+	if (byte & 0x80) {
+		return false;
+	}
+
+	value = patch.op_value;
+	patch.op_value = 0;
+	patch.op_shift = 0;
+
+	return true;
+}
+
+State OpByte(uint8_t byte)
+{
+	uint32_t value;
+
+	if (!VarintByte(byte, value)) {
+		return patch.op_shift < 35 ? State::kOp : State::kFailed;
+	}
+
+	Op op = static_cast<Op>(value & 7);
+	uint32_t n = value >> 3;
+
+	switch (op) {
+	case kCopy:
+		if (!SourceAvailable(n) || !Output(patch.source + patch.source_pos, n)) {
+			return State::kFailed;
+		}
+		patch.source_pos += n;
+		return State::kOp;
+	case kSeek:
+		// Checked when the source is next read
+		patch.source_pos += UnZigZag(n);
+		return State::kOp;
+	case kAdd:
+		if (!SourceAvailable(n)) {
+			return State::kFailed;
+		}
+		[[fallthrough]];
+	case kInsert:
+		patch.data_op = op;
+		patch.data_left = n;
+		return n > 0 ? State::kData : State::kOp;
+	case kMatch:
+		patch.data_left = n;
+		return State::kDistance;
+	}
+
+	return State::kFailed;
+}
+
+State DistanceByte(uint8_t byte)
+{
+	uint32_t distance;
+
+	if (!VarintByte(byte, distance)) {
+		return patch.op_shift < 35 ? State::kDistance : State::kFailed;
+	}
+
+	return Match(distance, patch.data_left) ? State::kOp : State::kFailed;
+}
+
+State Data(const uint8_t *data, size_t length)
+{
+	if (patch.data_op == kInsert) {
+		if (!Output(data, length)) {
+			return State::kFailed;
+		}
+	} else {
+		uint8_t sum[64];
+
+		for (size_t done = 0; done < length;) {
+			size_t n = MIN(length - done, sizeof(sum));
+
+			for (size_t i = 0; i < n; i++) {
+				sum[i] = patch.source[patch.source_pos + i] + data[done + i];
+			}
+			if (!Output(sum, n)) {
+				return State::kFailed;
+			}
+			patch.source_pos += n;
+			done += n;
+		}
+	}
+
+	patch.data_left -= length;
+
+	return patch.data_left > 0 ? State::kData : State::kOp;
+}
+
+int Open(int image_id, size_t image_size)
+{
+	patch = {};
+	patch.state = State::kHeader;
+	patch.source = RunningSlot();
+	patch.hash = psa_hash_operation_init();
+
+	return 0;
+}
+
+int Write(const uint8_t *chunk, size_t chunk_size)
+{
+	while (chunk_size > 0 && patch.state != State::kFailed) {
+		size_t used;
+
+		switch (patch.state) {
+		case State::kHeader:
+			used = MIN(chunk_size, sizeof(Header) - patch.header_used);
+			memcpy(reinterpret_cast<uint8_t *>(&patch.header) + patch.header_used, chunk, used);
+			patch.header_used += used;
+			if (patch.header_used == sizeof(Header)) {
+				patch.state = Start() ? State::kOp : State::kFailed;
+			}
+			break;
+		case State::kOp:
+			used = 1;
+			patch.state = OpByte(chunk[0]);
+			break;
+		case State::kDistance:
+			used = 1;
+			patch.state = DistanceByte(chunk[0]);
+			break;
+		default:
+			used = MIN(chunk_size, patch.data_left);
+			patch.state = Data(chunk, used);
+			break;
+		}
+
+		chunk += used;
+		chunk_size -= used;
+	}
+
+	return patch.state == State::kFailed ? -EINVAL : 0;
+}
+
+int Close(bool success)
+{
+	bool complete = success && patch.state == State::kOp && patch.written == patch.header.target_size;
+
+	// The last, partial burst
+	if (complete && patch.burst_used > 0) {
+		complete = Flush();
+	}
+
+	if (complete) {
+		uint8_t hash[kHashSize];
+		size_t hash_length;
+
+		complete = psa_hash_finish(&patch.hash, hash, sizeof(hash), &hash_length) == PSA_SUCCESS &&
+			   memcmp(hash, patch.header.target_hash, kHashSize) == 0;
+		if (!complete) {
+			LOG_ERR("Rebuilt image does not match the delta patch");
+		}
+	} else {
+		psa_hash_abort(&patch.hash);
+	}
+
+	if (patch.target_area != nullptr) {
+		flash_area_close(patch.target_area);
+		patch.target_area = nullptr;
+	}
+
+	if (!patch.target_open) {
+		return success ? -EINVAL : 0;
+	}
+
+	patch.target_open = false;
+
+	if (!complete) {
+		dfu_target_reset();
+		return success ? -EINVAL : 0;
+	}
+
+	return dfu_target_done(true);
+}
+
+} // namespace
+
+int DeltaPatchRegisterWriter()
+{
+	dfu_image_writer writer = {
+		.image_id = kDeltaPatchImageId,
+		.open = Open,
+		.write = Write,
+		.close = Close,
+	};
+
+	return dfu_multi_image_register_writer(&writer);
+}
+
+#endif // CONFIG_APP_OTA_DELTA
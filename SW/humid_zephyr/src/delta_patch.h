@@ -0,0 +1,39 @@
+#pragma once
+
+// Delta OTA images. scripts/ota_delta.py diffs a new signed app image
+// against the one running on the device, the patch is packed into the
+// DFU multi image package as image kDeltaPatchImageId instead of the full
+// image 0. As it downloads, the patch is applied straight into the secondary
+// slot, reading unchanged parts from the running slot, so nothing is staged.
+// A patch against an empty source is a compressed full image: it is built
+// from INSERT and MATCH alone and applies whatever the device runs.
+//
+// Patch format, little endian:
+//   "HDP2", u32 source size, u32 target size, u32 reserved,
+//   SHA-256 of the source image, SHA-256 of the target image
+// followed by operations varint(n << 3 | op):
+//   COPY   n bytes from the source
+//   ADD    n bytes follow, each added to the next source byte
+//   INSERT n bytes follow, written as they are
+//   SEEK   moves the source position by zigzag(n), no data
+//   MATCH  varint(d) follows, n bytes repeated from d bytes back in the
+//          rebuilt image, d may be less than n
+// The source position advances with COPY and ADD. A patch for a different
+// source image is rejected before anything is written, and the rebuilt image
+// is checked against the target hash before it is handed to MCUboot, which
+// still checks its signature.
+//
+// Output goes to dfu_target in 4 KB bursts aligned to the slot. MATCH reads
+// earlier output from the burst in RAM or back from the slot, so the whole
+// image serves as the dictionary without any RAM for it.
+constexpr int kDeltaPatchImageId = 0x44;
+
+#if CONFIG_APP_OTA_DELTA
+// Registers the patch writer, after every dfu_multi_image_init()
+int DeltaPatchRegisterWriter();
+#else
+inline int DeltaPatchRegisterWriter()
+{
+	return 0;
+}
+#endif // CONFIG_APP_OTA_DELTA
@@ -0,0 +1,73 @@
+#include "diagnostics_cluster.h"
+#include "footprint.h"
+#include "kvs_cache.h"
+#include "measure_scheduler.h"
+#include "sht4x.h"
+#include "trace.h"
+#include "tx_power.h"
+
+#include <app/AttributeAccessInterfaceRegistry.h>
+#include <lib/support/CodeUtils.h>
+
+using namespace ::chip;
+using namespace ::chip::app;
+
+CHIP_ERROR DiagnosticsCluster::Init(MeasureScheduler &measure_scheduler, Sht4x &sht4x, KvsCache &kvs_cache,
+				    TxPower &tx_power)
+{
+	scheduler = &measure_scheduler;
+	sensor = &sht4x;
+	storage = &kvs_cache;
+	radio = &tx_power;
+
+	VerifyOrReturnError(AttributeAccessInterfaceRegistry::Instance().Register(this), CHIP_ERROR_INCORRECT_STATE);
+
+	return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR DiagnosticsCluster::Read(const ConcreteReadAttributePath &path, AttributeValueEncoder &encoder)
+{
+	switch (path.mAttributeId) {
+	case HumidDiagnostics::Attributes::MeasurementInterval::Id:
+		return encoder.Encode(scheduler->IntervalSec());
+	case HumidDiagnostics::Attributes::SensorEnergyLastDay::Id:
+		return encoder.Encode(static_cast<uint32_t>(sensor->EnergyLastDay().energy_nj / 1000));
+	case HumidDiagnostics::Attributes::SensorEnergySavedLastDay::Id: {
+		const Sht4x::EnergyStats &stats = sensor->EnergyLastDay();
+		return encoder.Encode(static_cast<uint32_t>((stats.energy_all_high_nj - stats.energy_nj) / 1000));
+	}
+	case HumidDiagnostics::Attributes::PhaseDurations::Id:
+		return encoder.EncodeList([](const auto &list_encoder) -> CHIP_ERROR {
+			for (uint8_t phase = 0; phase < static_cast<uint8_t>(TracePhase::kCount); phase++) {
+				ReturnErrorOnFailure(list_encoder.Encode(TraceLastDurationUs(static_cast<TracePhase>(phase))));
+			}
+			return CHIP_NO_ERROR;
+		});
+	case HumidDiagnostics::Attributes::FootprintPeaks::Id:
+		return encoder.EncodeList([](const auto &list_encoder) -> CHIP_ERROR {
+#if CONFIG_APP_FOOTPRINT
+			for (uint8_t phase = 0; phase < static_cast<uint8_t>(FootprintPhase::kCount); phase++) {
+				FootprintPeaks peaks = FootprintPeaksOf(static_cast<FootprintPhase>(phase));
+
+				for (uint32_t value : {peaks.heap_bytes, peaks.chip_heap_bytes, peaks.packet_buffers,
+						       peaks.stack_free, peaks.events}) {
+					ReturnErrorOnFailure(list_encoder.Encode(value));
+				}
+			}
+#endif
+			return CHIP_NO_ERROR;
+		});
+	case HumidDiagnostics::Attributes::StorageWritesPerDay::Id:
+		return encoder.Encode(storage->WritesPerDay());
+	case HumidDiagnostics::Attributes::RadioTxPower::Id:
+		return encoder.Encode(radio->PowerDbm());
+	case HumidDiagnostics::Attributes::RadioRetryRate::Id:
+		return encoder.Encode(radio->RetryRate());
+	default:
+		// FeatureMap and ClusterRevision come from const_attributes.cpp through ember
+		return CHIP_NO_ERROR;
+	}
+}
+
+// Called by ember on startup, the attribute access interface is registered from DiagnosticsCluster::Init
+void MatterHumidDiagnosticsPluginServerInitCallback() {}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <app/AttributeAccessInterface.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+
+class KvsCache;
+class MeasureScheduler;
+class Sht4x;
+class TxPower;
+
+// Vendor specific cluster on the root endpoint, see humid-clusters.xml
+namespace HumidDiagnostics {
+
+inline constexpr chip::ClusterId Id = 0xFFF1FC00;
+
+namespace Attributes {
+namespace MeasurementInterval {
+// Current measurement interval in seconds
+inline constexpr chip::AttributeId Id = 0x0000;
+} // namespace MeasurementInterval
+namespace SensorEnergyLastDay {
+// Energy used by the SHT4x over the last full day in uJ, including heater pulses
+inline constexpr chip::AttributeId Id = 0x0001;
+} // namespace SensorEnergyLastDay
+namespace SensorEnergySavedLastDay {
+// Energy saved over the last full day in uJ by not always using high repeatability
+inline constexpr chip::AttributeId Id = 0x0002;
+} // namespace SensorEnergySavedLastDay
+namespace PhaseDurations {
+// Last duration of each TracePhase in us, indexed by phase
+inline constexpr chip::AttributeId Id = 0x0003;
+} // namespace PhaseDurations
+namespace FootprintPeaks {
+// FootprintPeaks fields of each FootprintPhase, phase major
+inline constexpr chip::AttributeId Id = 0x0004;
+} // namespace FootprintPeaks
+namespace StorageWritesPerDay {
+// Matter KVS writes that reached settings, per day since the retained copy was filled
+inline constexpr chip::AttributeId Id = 0x0005;
+} // namespace StorageWritesPerDay
+namespace RadioTxPower {
+// Thread TX power in dBm picked by the TX power control
+inline constexpr chip::AttributeId Id = 0x0006;
+} // namespace RadioTxPower
+namespace RadioRetryRate {
+// Failed Thread transmit attempts per mille over the last evaluation window
+inline constexpr chip::AttributeId Id = 0x0007;
+} // namespace RadioRetryRate
+} // namespace Attributes
+
+} // namespace HumidDiagnostics
+
+// Serves the HumidDiagnostics attributes from the modules that own the values
+class DiagnosticsCluster : public chip::app::AttributeAccessInterface {
+public:
+	DiagnosticsCluster()
+		: AttributeAccessInterface(chip::MakeOptional(chip::kRootEndpointId), HumidDiagnostics::Id)
+	{
+	}
+
+	CHIP_ERROR Init(MeasureScheduler &measure_scheduler, Sht4x &sht4x, KvsCache &kvs_cache, TxPower &tx_power);
+
+	CHIP_ERROR Read(const chip::app::ConcreteReadAttributePath &path,
+			chip::app::AttributeValueEncoder &encoder) override;
+
+private:
+	MeasureScheduler *scheduler = nullptr;
+	Sht4x *sensor = nullptr;
+	KvsCache *storage = nullptr;
+	TxPower *radio = nullptr;
+};
@@ -0,0 +1,105 @@
+#include "energy_budget.h"
+
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_REGISTER(energy_budget, CONFIG_CHIP_APP_LOG_LEVEL);
+
+#if CONFIG_APP_ENERGY_HARVEST
+
+#if !DT_NODE_HAS_STATUS_OKAY(DT_NODELABEL(vstor))
+#error "APP_ENERGY_HARVEST needs a vstor node, see harvest.overlay"
+#endif
+
+namespace {
+
+const struct device *vstor = DEVICE_DT_GET(DT_NODELABEL(vstor));
+const struct gpio_dt_spec vbat_ok = GPIO_DT_SPEC_GET(DT_PATH(zephyr_user), vbat_ok_gpios);
+
+// Change in VSTOR between samples that counts as charging, below the ADC noise
+// it is treated as draining so the node errs on the side of saving energy
+constexpr int32_t kChargingMv = 10;
+
+// A level is only left once VSTOR is this much above its threshold
+constexpr uint32_t kHysteresisMv = 50;
+
+} // namespace
+
+CHIP_ERROR EnergyBudget::Init()
+{
+	if (!device_is_ready(vstor) || !gpio_is_ready_dt(&vbat_ok)) {
+		LOG_ERR("Energy harvester monitor not ready");
+		return CHIP_NO_ERROR;
+	}
+
+	int rc = gpio_pin_configure_dt(&vbat_ok, GPIO_INPUT);
+	if (rc != 0) {
+		LOG_ERR("Failed to configure VBAT_OK: %d", rc);
+	}
+
+	return CHIP_NO_ERROR;
+}
+
+PowerPolicy::Level EnergyBudget::Sample()
+{
+	struct sensor_value value;
+	uint32_t previous_mv = vstor_mv;
+	PowerPolicy::Level new_level;
+	int rc;
+
+	rc = sensor_sample_fetch(vstor);
+	if (rc == 0) {
+		rc = sensor_channel_get(vstor, SENSOR_CHAN_VOLTAGE, &value);
+	}
+	if (rc != 0) {
+		// Can't tell how much energy is left, assume the worst
+		LOG_ERR("Failed to read VSTOR: %d", rc);
+		level = PowerPolicy::Level::kSurvival;
+		return level;
+	}
+
+	vstor_mv = MAX(sensor_value_to_milli(&value), 0);
+	bool charging = previous_mv > 0 && static_cast<int32_t>(vstor_mv - previous_mv) >= kChargingMv;
+	uint32_t plentiful_mv = CONFIG_APP_HARVEST_VSTOR_PLENTIFUL_MV;
+	uint32_t survival_mv = CONFIG_APP_HARVEST_VSTOR_SURVIVAL_MV;
+
+	// Only leave a level with some margin, so noise doesn't toggle it
+	if (level == PowerPolicy::Level::kSurvival) {
+		survival_mv += kHysteresisMv;
+	}
+	if (level != PowerPolicy::Level::kNormal) {
+		plentiful_mv += kHysteresisMv;
+	}
+
+	if (gpio_pin_get_dt(&vbat_ok) != 1 || vstor_mv < survival_mv) {
+		new_level = PowerPolicy::Level::kSurvival;
+	} else if (vstor_mv >= plentiful_mv) {
+		new_level = PowerPolicy::Level::kNormal;
+	} else {
+		new_level = charging ? PowerPolicy::Level::kLow : PowerPolicy::Level::kCritical;
+	}
+
+	if (new_level != level) {
+		LOG_INF("VSTOR %u mV (%s), energy level %d -> %d", vstor_mv, charging ? "charging" : "draining",
+			static_cast<int>(level), static_cast<int>(new_level));
+	}
+	level = new_level;
+
+	return level;
+}
+
+#else
+
+CHIP_ERROR EnergyBudget::Init()
+{
+	return CHIP_NO_ERROR;
+}
+
+PowerPolicy::Level EnergyBudget::Sample()
+{
+	return level;
+}
+
+#endif // CONFIG_APP_ENERGY_HARVEST
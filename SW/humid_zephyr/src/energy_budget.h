@@ -0,0 +1,37 @@
+#pragma once
+
+#include "power_policy.h"
+
+#include <lib/core/CHIPError.h>
+
+#include <stdint.h>
+
+// Energy budget governor for nodes running off an energy harvester
+// (BQ25570/BQ25505) and a storage capacitor.
+//
+// Reads the storage capacitor voltage (vstor) and the harvester's VBAT_OK
+// output on every measurement and turns them into a PowerPolicy level:
+// - normal while VSTOR is above CONFIG_APP_HARVEST_VSTOR_PLENTIFUL_MV
+// - low while below that but the capacitor is charging, critical while it
+//   is draining, so the duty cycle follows the harvested power
+// - survival once VBAT_OK drops or VSTOR is below
+//   CONFIG_APP_HARVEST_VSTOR_SURVIVAL_MV
+//
+// Non-urgent work such as OTA queries and heater pulses should only run
+// while Plentiful().
+class EnergyBudget {
+public:
+	CHIP_ERROR Init();
+
+	// Sample the storage capacitor, returns the resulting level
+	PowerPolicy::Level Sample();
+
+	PowerPolicy::Level GetLevel() const { return level; }
+	bool Plentiful() const { return level == PowerPolicy::Level::kNormal; }
+
+	uint32_t VstorMv() const { return vstor_mv; }
+
+private:
+	PowerPolicy::Level level = PowerPolicy::Level::kNormal;
+	uint32_t vstor_mv = 0;
+};
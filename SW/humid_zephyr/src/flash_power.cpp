@@ -0,0 +1,93 @@
+#include "flash_power.h"
+
+#if CONFIG_APP_EXT_FLASH_SLEEP
+
+#include <lib/support/CodeUtils.h>
+#include <platform/CHIPDeviceLayer.h>
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/pm/device_runtime.h>
+
+LOG_MODULE_REGISTER(flash_power, CONFIG_CHIP_APP_LOG_LEVEL);
+
+using namespace ::chip;
+using namespace ::chip::DeviceLayer;
+
+namespace {
+
+const struct device *const flash = DEVICE_DT_GET(DT_CHOSEN(nordic_pm_ext_flash));
+
+} // namespace
+
+CHIP_ERROR FlashPower::Init()
+{
+	if (!device_is_ready(flash)) {
+		LOG_ERR("External flash not ready");
+		return CHIP_ERROR_INCORRECT_STATE;
+	}
+
+	return SystemLayer().ScheduleLambda([this] {
+		// Runtime PM suspends the idle device right away
+		int ret = pm_device_runtime_enable(flash);
+
+		if (ret != 0) {
+			LOG_ERR("Failed to enable external flash runtime PM: %d", ret);
+			return;
+		}
+
+		Sleep();
+	});
+}
+
+void FlashPower::DoAction(Action action)
+{
+	int ret;
+
+	if (action == Action::WAKE_UP) {
+		if (awake) {
+			return;
+		}
+
+		ret = pm_device_runtime_get(flash);
+		if (ret != 0) {
+			LOG_ERR("Failed to wake external flash: %d", ret);
+			return;
+		}
+
+		awake = true;
+		awake_since_ms = k_uptime_get();
+		return;
+	}
+
+	if (!awake) {
+		return;
+	}
+
+	ret = pm_device_runtime_put(flash);
+	if (ret != 0) {
+		LOG_ERR("Failed to put external flash to sleep: %d", ret);
+		return;
+	}
+
+	Sleep();
+}
+
+void FlashPower::Sleep()
+{
+	int64_t now_ms = k_uptime_get();
+
+	awake = false;
+	awake_total_ms += static_cast<uint32_t>(now_ms - awake_since_ms);
+
+	// Datasheet standby current over the time asleep, nA x ms to uAh
+	uint64_t asleep_ms = now_ms - awake_total_ms;
+	uint32_t saved_uah = static_cast<uint32_t>(asleep_ms * CONFIG_APP_EXT_FLASH_STANDBY_NA / 3600000000ULL);
+
+	LOG_INF("External flash in deep power-down, %u ms awake since boot, "
+		"%u uAh saved against standby estimated",
+		awake_total_ms, saved_uah);
+}
+
+#endif // CONFIG_APP_EXT_FLASH_SLEEP
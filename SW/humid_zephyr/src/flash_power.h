@@ -0,0 +1,37 @@
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <platform/nrfconnect/ExternalFlashManager.h>
+
+#include <stdint.h>
+
+// Keeps the external SPI NOR flash holding mcuboot_secondary in deep
+// power-down. The flash is only used by OTA, the image processor wakes it
+// for a download and the apply, and puts it back to sleep once the image is
+// written, the update applied or aborted. In standby the MX25R64 draws
+// about CONFIG_APP_EXT_FLASH_STANDBY_NA, in deep power-down well under
+// 0.1 uA. The difference is logged as an estimate of the charge saved, from
+// that datasheet figure, not measured.
+//
+// The upstream flash manager only handles QSPI flash, this one drives the
+// jedec,spi-nor chip through runtime PM, whose suspend action sends it to
+// deep power-down.
+class FlashPower : public chip::DeviceLayer::ExternalFlashManager {
+public:
+#if CONFIG_APP_EXT_FLASH_SLEEP
+	// Puts the flash to sleep once the events queued so far have run, the
+	// OTA requestor checks the slot state on the first run of an image
+	CHIP_ERROR Init();
+
+	void DoAction(Action action) override;
+
+private:
+	void Sleep();
+
+	bool awake = true;
+	int64_t awake_since_ms = 0;
+	uint32_t awake_total_ms = 0;
+#else
+	CHIP_ERROR Init() { return CHIP_NO_ERROR; }
+#endif // CONFIG_APP_EXT_FLASH_SLEEP
+};
@@ -0,0 +1,234 @@
+#include "footprint.h"
+
+#if CONFIG_APP_FOOTPRINT
+
+#include <app/EventManagement.h>
+#include <app/server/Server.h>
+#include <lib/support/CodeUtils.h>
+#include <platform/CHIPDeviceLayer.h>
+#include <system/SystemConfig.h>
+
+#if CONFIG_CHIP_MALLOC_SYS_HEAP
+#include <platform/Zephyr/SysHeapMalloc.h>
+#endif
+
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+#include <system/SystemStats.h>
+#endif
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/sys_heap.h>
+#include <zephyr/sys/util.h>
+
+#include <stdio.h>
+
+LOG_MODULE_REGISTER(footprint, CONFIG_CHIP_APP_LOG_LEVEL);
+
+#if K_HEAP_MEM_POOL_SIZE > 0
+extern "C" struct k_heap _system_heap;
+#endif
+
+using namespace ::chip;
+using namespace ::chip::DeviceLayer;
+
+namespace {
+
+struct ThreadMark {
+	const struct k_thread *thread;
+	size_t size;
+	size_t unused;
+};
+
+struct PhaseMarks {
+	FootprintPeaks peaks;
+	ThreadMark threads[CONFIG_APP_FOOTPRINT_MAX_THREADS];
+	uint8_t thread_count;
+	bool sampled;
+};
+
+PhaseMarks phases[static_cast<size_t>(FootprintPhase::kCount)];
+FootprintPhase current = FootprintPhase::kCommissioning;
+EventNumber events_at_init;
+
+// Sampled from the CHIP thread and the shell
+K_MUTEX_DEFINE(lock);
+
+void SampleThread(const struct k_thread *thread, void *user_data)
+{
+	PhaseMarks *marks = static_cast<PhaseMarks *>(user_data);
+	size_t unused;
+
+	if (marks->thread_count == ARRAY_SIZE(marks->threads) ||
+	    k_thread_stack_space_get(thread, &unused) != 0) {
+		return;
+	}
+
+	marks->threads[marks->thread_count++] = {thread, thread->stack_info.size, unused};
+	marks->peaks.stack_free = MIN(marks->peaks.stack_free, unused);
+}
+
+void Sample(PhaseMarks &marks)
+{
+	FootprintPeaks &peaks = marks.peaks;
+
+	peaks = {};
+
+#if K_HEAP_MEM_POOL_SIZE > 0
+	struct sys_memory_stats heap;
+
+	if (sys_heap_runtime_stats_get(&_system_heap.heap, &heap) == 0) {
+		peaks.heap_bytes = heap.max_allocated_bytes;
+	}
+#endif
+
+#if CONFIG_CHIP_MALLOC_SYS_HEAP
+	Malloc::Stats chip_heap;
+
+	if (Malloc::GetStats(chip_heap) == CHIP_NO_ERROR) {
+		peaks.chip_heap_bytes = chip_heap.maxUsed;
+	}
+#endif
+
+	// Without a pool packet buffers are allocated from the Matter heap
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS && CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE > 0
+	peaks.packet_buffers = System::Stats::GetHighWatermarks()[System::Stats::kSystemLayer_NumPacketBufs];
+#endif
+
+	peaks.events = app::EventManagement::GetInstance().GetLastEventNumber() - events_at_init;
+
+	peaks.stack_free = UINT32_MAX;
+	marks.thread_count = 0;
+	k_thread_foreach_unlocked(SampleThread, &marks);
+
+	marks.sampled = true;
+}
+
+void ChipEventHandler(const ChipDeviceEvent *event, intptr_t arg)
+{
+	if (event->Type == DeviceEventType::kCommissioningComplete) {
+		FootprintEnterPhase(FootprintPhase::kSteady);
+	}
+}
+
+} // namespace
+
+CHIP_ERROR FootprintInit()
+{
+	events_at_init = app::EventManagement::GetInstance().GetLastEventNumber();
+	current = Server::GetInstance().GetFabricTable().FabricCount() > 0 ? FootprintPhase::kSteady
+									     : FootprintPhase::kCommissioning;
+
+	return PlatformMgr().AddEventHandler(ChipEventHandler, 0);
+}
+
+void FootprintEnterPhase(FootprintPhase phase)
+{
+	k_mutex_lock(&lock, K_FOREVER);
+	Sample(phases[static_cast<size_t>(current)]);
+	current = phase;
+	k_mutex_unlock(&lock);
+}
+
+FootprintPeaks FootprintPeaksOf(FootprintPhase phase)
+{
+	k_mutex_lock(&lock, K_FOREVER);
+	if (phase == current) {
+		Sample(phases[static_cast<size_t>(phase)]);
+	}
+	// Copied under the lock, a phase change or the shell may sample again
+	FootprintPeaks peaks = phases[static_cast<size_t>(phase)].peaks;
+	k_mutex_unlock(&lock);
+
+	return peaks;
+}
+
+#ifdef CONFIG_SHELL
+
+#include <zephyr/shell/shell.h>
+
+namespace {
+
+const char *const kPhaseNames[] = {"commissioning", "ota", "steady"};
+
+static_assert(ARRAY_SIZE(kPhaseNames) == static_cast<size_t>(FootprintPhase::kCount));
+
+const ThreadMark *FindThread(const PhaseMarks &marks, const struct k_thread *thread)
+{
+	for (size_t i = 0; i < marks.thread_count; i++) {
+		if (marks.threads[i].thread == thread) {
+			return &marks.threads[i];
+		}
+	}
+
+	return nullptr;
+}
+
+void PrintPeak(const struct shell *shell, const char *name, uint32_t FootprintPeaks::*field)
+{
+	char line[80];
+	int len = snprintf(line, sizeof(line), "%-16s", name);
+
+	for (const PhaseMarks &marks : phases) {
+		if (marks.sampled) {
+			len += snprintf(line + len, sizeof(line) - len, " %13u", marks.peaks.*field);
+		} else {
+			len += snprintf(line + len, sizeof(line) - len, " %13s", "-");
+		}
+	}
+
+	shell_print(shell, "%s", line);
+}
+
+static int ReportCommand(const struct shell *shell, size_t argc, char **argv)
+{
+	k_mutex_lock(&lock, K_FOREVER);
+	Sample(phases[static_cast<size_t>(current)]);
+
+	shell_print(shell, "Current phase: %s", kPhaseNames[static_cast<size_t>(current)]);
+	shell_print(shell, "%-16s %13s %13s %13s", "peak", kPhaseNames[0], kPhaseNames[1], kPhaseNames[2]);
+	PrintPeak(shell, "heap bytes", &FootprintPeaks::heap_bytes);
+	PrintPeak(shell, "chip heap bytes", &FootprintPeaks::chip_heap_bytes);
+	PrintPeak(shell, "packet buffers", &FootprintPeaks::packet_buffers);
+	PrintPeak(shell, "min stack free", &FootprintPeaks::stack_free);
+	PrintPeak(shell, "events", &FootprintPeaks::events);
+
+	// Stack used, threads are listed as they are now
+	const PhaseMarks &now = phases[static_cast<size_t>(current)];
+
+	shell_print(shell, "");
+	shell_print(shell, "%-16s %6s %13s %13s %13s", "stack used", "size", kPhaseNames[0], kPhaseNames[1],
+		    kPhaseNames[2]);
+	for (size_t i = 0; i < now.thread_count; i++) {
+		const ThreadMark &thread = now.threads[i];
+		const char *name = k_thread_name_get(const_cast<struct k_thread *>(thread.thread));
+		char line[80];
+		int len = snprintf(line, sizeof(line), "%-16.16s %6u", name ? name : "?",
+			       static_cast<uint32_t>(thread.size));
+
+		for (const PhaseMarks &marks : phases) {
+			const ThreadMark *mark = FindThread(marks, thread.thread);
+
+			if (mark) {
+				len += snprintf(line + len, sizeof(line) - len, " %13u",
+						static_cast<uint32_t>(mark->size - mark->unused));
+			} else {
+				len += snprintf(line + len, sizeof(line) - len, " %13s", "-");
+			}
+		}
+
+		shell_print(shell, "%s", line);
+	}
+	k_mutex_unlock(&lock);
+
+	return 0;
+}
+
+SHELL_CMD_REGISTER(footprint, NULL, "Stack, heap, packet buffer and event high-water marks per phase",
+		   ReportCommand);
+
+} // namespace
+
+#endif // CONFIG_SHELL
+
+#endif // CONFIG_APP_FOOTPRINT
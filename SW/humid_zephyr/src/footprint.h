@@ -0,0 +1,43 @@
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include <stdint.h>
+
+// Lifecycle phases that memory high-water marks are attributed to
+enum class FootprintPhase : uint8_t {
+	kCommissioning, // Boot until commissioning completes
+	kOta,           // OTA query, download and apply
+	kSteady,        // Commissioned, measuring and reporting
+	kCount,
+};
+
+// High-water marks since boot, as of the end of a phase. They only grow,
+// so a phase that raised one shows a larger value than the phase before.
+struct FootprintPeaks {
+	uint32_t heap_bytes;      // Kernel heap, k_malloc
+	uint32_t chip_heap_bytes; // Matter heap, CONFIG_CHIP_MALLOC_SYS_HEAP
+	uint32_t packet_buffers;  // Matter packet buffers, when they come from a pool
+	uint32_t stack_free;      // Least unused stack of any thread, in bytes
+	uint32_t events;          // Matter events logged since boot
+};
+
+#if CONFIG_APP_FOOTPRINT
+
+CHIP_ERROR FootprintInit();
+
+// Snapshot the marks into the current phase and move on to the next one
+void FootprintEnterPhase(FootprintPhase phase);
+
+// Copy of the marks of a phase, the current one is sampled first
+FootprintPeaks FootprintPeaksOf(FootprintPhase phase);
+
+#else
+
+inline CHIP_ERROR FootprintInit()
+{
+	return CHIP_NO_ERROR;
+}
+inline void FootprintEnterPhase(FootprintPhase phase) {}
+
+#endif // CONFIG_APP_FOOTPRINT
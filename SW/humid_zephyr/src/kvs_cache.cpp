@@ -0,0 +1,494 @@
+#include "kvs_cache.h"
+#include "reset_cause.h"
+
+#if CONFIG_APP_KVS_CACHE
+
+#include <app/SimpleSubscriptionResumptionStorage.h>
+#include <credentials/PersistentStorageOpCertStore.h>
+#include <lib/support/CodeUtils.h>
+#include <platform/CHIPDeviceConfig.h>
+#include <protocols/secure_channel/SimpleSessionResumptionStorage.h>
+
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/hwinfo.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/random/random.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/util.h>
+
+#if CONFIG_NRF_GRTC_TIMER
+#include <zephyr/drivers/timer/nrf_grtc_timer.h>
+#endif
+
+#include <stddef.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(kvs_cache, CONFIG_CHIP_APP_LOG_LEVEL);
+
+#define KVS_CACHE_NODE DT_NODELABEL(kvs_cache_ram)
+#define KVS_CACHE_ADDR (DT_REG_ADDR(DT_NODELABEL(retained_sram)) + DT_REG_ADDR(KVS_CACHE_NODE))
+#define KVS_CACHE_SIZE DT_REG_SIZE(KVS_CACHE_NODE)
+
+namespace {
+
+constexpr uint32_t kMagic = 0x4b564334; // "KVC4"
+
+// Random value written to settings on every cold start, the copy only
+// belongs to the settings holding the same one
+constexpr char kTokenKey[] = "hu/kt";
+
+// Resets after which the KVS is still what the copy was filled from
+constexpr uint32_t kWarmResets = RESET_SOFTWARE | RESET_LOW_POWER_WAKE | RESET_WATCHDOG | RESET_CPU_LOCKUP;
+
+// Entry flags
+constexpr uint8_t kAbsent = BIT(0); // Not in the KVS either
+constexpr uint8_t kDirty = BIT(1);  // Deferred, settings do not have it yet
+
+// Resumption records, only written to settings in a flush
+constexpr const char *kDeferredPrefixes[] = {
+	"g/s/",  // SessionResumption
+	"g/sri", // SessionResumptionIndex
+	"g/su/", // SubscriptionResumption
+	"g/sum", // SubscriptionResumptionMaxCount
+};
+
+// Entries are packed back to back: header, key, value, padded to 4 bytes
+struct Entry {
+	uint8_t key_length;
+	uint8_t flags;
+	uint16_t value_length;
+};
+
+constexpr size_t kHeaderSize = 56;
+
+struct Region {
+	uint32_t magic;
+	uint32_t software_version;
+	uint32_t token;
+	uint32_t reserved;
+	// Odd while a write is in progress
+	uint32_t generation;
+	uint32_t crc;
+	// Covered by the CRC, from here up to the end of the entries
+	uint32_t used;
+	uint32_t count;
+	uint64_t filled_us;
+	// When the oldest deferred record was written, 0 when there is none
+	uint64_t dirty_us;
+	// Writes and deletes since filled_us, to settings and from the stack
+	uint32_t writes;
+	uint32_t requests;
+	uint8_t data[KVS_CACHE_SIZE - kHeaderSize];
+};
+
+static_assert(offsetof(Region, data) == kHeaderSize, "Update kHeaderSize");
+static_assert(sizeof(Region) <= KVS_CACHE_SIZE, "KVS cache does not fit kvs_cache_ram");
+
+Region *const region = reinterpret_cast<Region *>(KVS_CACHE_ADDR);
+
+chip::Credentials::PersistentStorageOpCertStore op_cert_store;
+chip::SimpleSessionResumptionStorage session_storage;
+chip::app::SimpleSubscriptionResumptionStorage subscription_storage;
+
+// us, the GRTC keeps counting through System OFF and resets
+uint64_t Now()
+{
+#if CONFIG_NRF_GRTC_TIMER
+	return z_nrf_grtc_timer_read();
+#else
+	return k_cyc_to_us_floor64(k_cycle_get_64());
+#endif
+}
+
+uint32_t Crc()
+{
+	const uint8_t *start = reinterpret_cast<const uint8_t *>(&region->used);
+
+	return crc32_ieee(start, region->data + region->used - start);
+}
+
+bool Intact()
+{
+	return region->magic == kMagic && (region->generation & 1) == 0 && region->used <= sizeof(region->data) &&
+	       region->crc == Crc();
+}
+
+void Clear(uint32_t token)
+{
+	memset(region, 0, kHeaderSize);
+	region->magic = kMagic;
+	region->software_version = CHIP_DEVICE_CONFIG_DEVICE_SOFTWARE_VERSION;
+	region->token = token;
+	region->filled_us = Now();
+	region->crc = Crc();
+}
+
+// Brackets every change to the KVS, a reset in between leaves the generation odd
+void BeginWrite()
+{
+	region->generation++;
+}
+
+void EndWrite()
+{
+	region->crc = Crc();
+	region->generation++;
+}
+
+uint32_t PerDay(uint32_t count)
+{
+	uint64_t elapsed_us = Now() - region->filled_us;
+
+	return elapsed_us > 0 ? static_cast<uint32_t>(count * 86400ULL * USEC_PER_SEC / elapsed_us) : 0;
+}
+
+bool StartsWith(const char *key, const char *prefix)
+{
+	return strncmp(key, prefix, strlen(prefix)) == 0;
+}
+
+bool IsDeferred(const char *key)
+{
+	for (const char *prefix : kDeferredPrefixes) {
+		if (StartsWith(key, prefix)) {
+			return true;
+		}
+	}
+
+	// FabricSession, f/<fabric index>/s/<node id>
+	const char *fabric_end = StartsWith(key, "f/") ? strchr(key + 2, '/') : nullptr;
+
+	return fabric_end != nullptr && StartsWith(fabric_end, "/s/");
+}
+
+Entry *EntryAt(uint32_t offset)
+{
+	return reinterpret_cast<Entry *>(&region->data[offset]);
+}
+
+uint32_t EntrySize(const Entry *entry)
+{
+	return ROUND_UP(sizeof(Entry) + entry->key_length + entry->value_length, 4);
+}
+
+const char *KeyOf(Entry *entry)
+{
+	return reinterpret_cast<const char *>(entry + 1);
+}
+
+uint8_t *ValueOf(Entry *entry)
+{
+	return reinterpret_cast<uint8_t *>(entry + 1) + entry->key_length;
+}
+
+Entry *Find(const char *key)
+{
+	size_t key_length = strlen(key);
+
+	for (uint32_t offset = 0; offset < region->used;) {
+		Entry *entry = EntryAt(offset);
+
+		if (entry->key_length == key_length && memcmp(KeyOf(entry), key, key_length) == 0) {
+			return entry;
+		}
+		offset += EntrySize(entry);
+	}
+
+	return nullptr;
+}
+
+void Remove(const char *key)
+{
+	Entry *entry = Find(key);
+
+	if (entry == nullptr) {
+		return;
+	}
+
+	uint8_t *start = reinterpret_cast<uint8_t *>(entry);
+	uint32_t size = EntrySize(entry);
+	uint32_t tail = region->used - (start - region->data) - size;
+
+	memmove(start, start + size, tail);
+	region->used -= size;
+	region->count--;
+}
+
+// Replaces the entry of key, false when it does not fit and was left out
+bool Store(const char *key, const void *value, uint16_t value_length, uint8_t flags)
+{
+	size_t key_length = strlen(key);
+	uint32_t size = ROUND_UP(sizeof(Entry) + key_length + value_length, 4);
+
+	Remove(key);
+
+	if (key_length > chip::PersistentStorageDelegate::kKeyLengthMax ||
+	    region->used + size > sizeof(region->data)) {
+		LOG_DBG("No room for %s, %u bytes", key, value_length);
+		return false;
+	}
+
+	Entry *entry = EntryAt(region->used);
+
+	entry->key_length = static_cast<uint8_t>(key_length);
+	entry->flags = flags;
+	entry->value_length = value_length;
+	memcpy(reinterpret_cast<uint8_t *>(entry + 1), key, key_length);
+	if (value_length > 0) {
+		memcpy(ValueOf(entry), value, value_length);
+	}
+	region->used += size;
+	region->count++;
+
+	return true;
+}
+
+} // namespace
+
+CHIP_ERROR KvsCache::Init(chip::CommonCaseDeviceServerInitParams &params)
+{
+	VerifyOrReturnError(params.persistentStorageDelegate != nullptr, CHIP_ERROR_INCORRECT_STATE);
+	backing = params.persistentStorageDelegate;
+	enabled = true;
+
+	uint32_t reset_cause = ResetCause();
+	bool warm_reset = reset_cause != 0 && (reset_cause & ~kWarmResets) == 0;
+
+	// The one key every boot reads from settings: a reset that looks warm
+	// can still come with other settings, a debugger erasing them or a
+	// factory reset the fabric delegate did not see
+	uint32_t token = 0;
+	uint16_t size = sizeof(token);
+	bool same_settings = backing->SyncGetKeyValue(kTokenKey, &token, size) == CHIP_NO_ERROR &&
+			     size == sizeof(token) && region->token == token;
+
+	bool intact = warm_reset && same_settings && Intact();
+
+	if (intact && region->software_version == CHIP_DEVICE_CONFIG_DEVICE_SOFTWARE_VERSION) {
+		LOG_INF("KVS cache kept, %u entries, %u bytes, %u updates", region->count, region->used,
+			region->generation / 2);
+	} else {
+		// Rebooted into a new image, what the old one deferred still goes to settings
+		if (intact) {
+			Flush(true);
+		}
+		LOG_INF("KVS cache cleared, reset cause 0x%08x%s", reset_cause,
+			same_settings ? "" : ", settings changed");
+		token = sys_rand32_get();
+		ReturnErrorOnFailure(backing->SyncSetKeyValue(kTokenKey, &token, sizeof(token)));
+		Clear(token);
+	}
+
+	// Everything the server reads through params, the operational keys stay
+	// in the keystore InitializeStaticResourcesBeforeServerInit() set up
+	ReturnErrorOnFailure(op_cert_store.Init(this));
+	ReturnErrorOnFailure(session_storage.Init(this));
+	ReturnErrorOnFailure(subscription_storage.Init(this));
+	params.persistentStorageDelegate = this;
+	params.opCertStore = &op_cert_store;
+	params.sessionResumptionStorage = &session_storage;
+	params.subscriptionResumptionStorage = &subscription_storage;
+
+	return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR KvsCache::Attach()
+{
+	LOG_INF("Server init read %u keys from the KVS cache, %u from settings", hits, misses);
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+	VerifyOrReturnError(chip::Server::GetInstance().GetICDManager().RegisterObserver(this) != nullptr,
+			    CHIP_ERROR_NO_MEMORY);
+#endif
+
+	return chip::Server::GetInstance().GetFabricTable().AddFabricDelegate(this);
+}
+
+void KvsCache::OnFabricRemoved(const chip::FabricTable &fabric_table, chip::FabricIndex fabric_index)
+{
+	if (fabric_table.FabricCount() > 0 || !enabled) {
+		return;
+	}
+
+	// A factory reset erases the KVS without telling, read through until the reboot
+	enabled = false;
+	region->magic = 0;
+	LOG_INF("Last fabric removed, KVS cache dropped");
+}
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+void KvsCache::OnTransitionToIdle()
+{
+	// The wake is about to end, the radio is still up and the CPU awake
+	Flush(false);
+}
+#endif
+
+void KvsCache::Flush(bool force)
+{
+	if (!enabled || region->dirty_us == 0) {
+		return;
+	}
+
+	bool due = Now() - region->dirty_us >= CONFIG_APP_KVS_FLUSH_INTERVAL_SEC * USEC_PER_SEC;
+	bool full = region->used > sizeof(region->data) * 3 / 4;
+
+	if (!force && !due && !full) {
+		return;
+	}
+
+	uint32_t flushed = 0;
+	bool left = false;
+
+	BeginWrite();
+
+	for (uint32_t offset = 0; offset < region->used; offset += EntrySize(EntryAt(offset))) {
+		Entry *entry = EntryAt(offset);
+		char key[chip::PersistentStorageDelegate::kKeyLengthMax + 1];
+		CHIP_ERROR err;
+
+		if (!(entry->flags & kDirty)) {
+			continue;
+		}
+
+		memcpy(key, KeyOf(entry), entry->key_length);
+		key[entry->key_length] = '\0';
+
+		// Only a copy left by an older image has deferred deletes
+		if (entry->flags & kAbsent) {
+			err = backing->SyncDeleteKeyValue(key);
+			if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND) {
+				err = CHIP_NO_ERROR;
+			}
+		} else {
+			err = backing->SyncSetKeyValue(key, ValueOf(entry), entry->value_length);
+		}
+
+		if (err != CHIP_NO_ERROR) {
+			// Stays dirty for the next flush
+			LOG_ERR("Failed to write %s: %" CHIP_ERROR_FORMAT, key, err.Format());
+			left = true;
+			continue;
+		}
+
+		entry->flags &= ~kDirty;
+		region->writes++;
+		flushed++;
+	}
+
+	if (!left) {
+		region->dirty_us = 0;
+	}
+
+	EndWrite();
+
+	LOG_INF("Flushed %u deferred records, %u settings writes per day for %u requested", flushed,
+		WritesPerDay(), PerDay(region->requests));
+}
+
+uint32_t KvsCache::WritesPerDay() const
+{
+	return PerDay(region->writes);
+}
+
+CHIP_ERROR KvsCache::SyncGetKeyValue(const char *key, void *buffer, uint16_t &size)
+{
+	Entry *entry = enabled ? Find(key) : nullptr;
+
+	if (entry != nullptr) {
+		hits++;
+
+		if (entry->flags & kAbsent) {
+			return CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND;
+		}
+
+		uint16_t length = entry->value_length;
+		uint16_t copied = MIN(size, length);
+
+		if (copied > 0) {
+			memcpy(buffer, ValueOf(entry), copied);
+		}
+		size = length;
+		return copied < length ? CHIP_ERROR_BUFFER_TOO_SMALL : CHIP_NO_ERROR;
+	}
+
+	misses++;
+
+	CHIP_ERROR err = backing->SyncGetKeyValue(key, buffer, size);
+
+	if (!enabled) {
+		return err;
+	}
+
+	// A buffer too small only returned part of the value, it is read again
+	if (err == CHIP_NO_ERROR || err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND) {
+		BeginWrite();
+		Store(key, buffer, err == CHIP_NO_ERROR ? size : 0, err == CHIP_NO_ERROR ? 0 : kAbsent);
+		EndWrite();
+	}
+
+	return err;
+}
+
+CHIP_ERROR KvsCache::SyncSetKeyValue(const char *key, const void *value, uint16_t size)
+{
+	if (!enabled) {
+		return backing->SyncSetKeyValue(key, value, size);
+	}
+
+	BeginWrite();
+	region->requests++;
+
+	if (IsDeferred(key) && Store(key, value, size, kDirty)) {
+		if (region->dirty_us == 0) {
+			region->dirty_us = Now();
+		}
+		EndWrite();
+		// Due or full, without waiting for the end of the active period
+		Flush(false);
+		return CHIP_NO_ERROR;
+	}
+
+	CHIP_ERROR err = backing->SyncSetKeyValue(key, value, size);
+
+	if (err == CHIP_NO_ERROR) {
+		region->writes++;
+		Store(key, value, size, 0);
+	} else {
+		// Not known what the KVS holds now, read it through next time
+		Remove(key);
+	}
+
+	EndWrite();
+
+	return err;
+}
+
+CHIP_ERROR KvsCache::SyncDeleteKeyValue(const char *key)
+{
+	if (!enabled) {
+		return backing->SyncDeleteKeyValue(key);
+	}
+
+	BeginWrite();
+	region->requests++;
+
+	// Deletes are never deferred, not even of resumption records: after a
+	// supply loss a deleted record would come back, and could match a
+	// fabric that reuses the index or a subscription that has ended
+	CHIP_ERROR err = backing->SyncDeleteKeyValue(key);
+
+	if (err == CHIP_NO_ERROR || err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND) {
+		region->writes++;
+		Store(key, nullptr, 0, kAbsent);
+	} else {
+		Remove(key);
+	}
+
+	EndWrite();
+
+	return err;
+}
+
+#endif // CONFIG_APP_KVS_CACHE
@@ -0,0 +1,98 @@
+#pragma once
+
+// Retained RAM copy of the Matter KVS. Every boot, including each wake from
+// System OFF, Server::Init reads the fabric table and its certificates, the
+// message counters, the ICD monitoring entries, the session and subscription
+// resumption state, and the OTA requestor reads its state, each key a
+// lookup in settings. This delegate sits between the Matter stack and the
+// KVS: reads are served from kvs_cache_ram once seen, including keys that
+// do not exist. Entries that do not fit are not cached and read through.
+//
+// It also coalesces writes to settings:
+// - session and subscription resumption records change on every CASE
+//   session and subscription. They are only kept in the copy, and written
+//   out together at the end of an ICD active period, once the oldest is
+//   CONFIG_APP_KVS_FLUSH_INTERVAL_SEC old or the copy fills up. Losing them
+//   to a power loss costs a full CASE session and a new subscription.
+//   Deleting them goes to settings right away, a deleted record must not
+//   come back after a power loss.
+// Everything else goes through to settings before the copy is updated. That
+// includes the monotonic counters: the stack already only writes them once
+// per epoch, holding them back would add to the steps lost with the supply.
+//
+// The copy is only used when it can be trusted:
+// - its CRC matches and the generation counter is even, it is odd while a
+//   write is on its way to the KVS and the copy,
+// - it was filled by this software version,
+// - the boot was a wake from System OFF or a software or watchdog reset,
+//   power on, pin and debugger resets may come with a new flash content,
+// - settings hold the random token written when the copy was filled, a
+//   settings read per boot that catches settings erased or replaced behind
+//   a warm looking reset.
+// It is dropped when the last fabric is removed, before a factory reset
+// erases the KVS underneath it.
+
+#include <app/server/Server.h>
+#include <credentials/FabricTable.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/CHIPPersistentStorageDelegate.h>
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+#include <app/icd/server/ICDStateObserver.h>
+#endif
+
+#include <stdint.h>
+
+#if CONFIG_APP_KVS_CACHE
+
+class KvsCache : public chip::PersistentStorageDelegate,
+		 public chip::FabricTable::Delegate
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+	,
+		 public chip::app::ICDStateObserver
+#endif
+{
+public:
+	// Call after InitializeStaticResourcesBeforeServerInit(), puts the cache
+	// in front of the KVS for everything params hands to the server
+	CHIP_ERROR Init(chip::CommonCaseDeviceServerInitParams &params);
+
+	// Call after Server::Init(), follows fabric removals and ICD active periods
+	CHIP_ERROR Attach();
+
+	CHIP_ERROR SyncGetKeyValue(const char *key, void *buffer, uint16_t &size) override;
+	CHIP_ERROR SyncSetKeyValue(const char *key, const void *value, uint16_t size) override;
+	CHIP_ERROR SyncDeleteKeyValue(const char *key) override;
+
+	void OnFabricRemoved(const chip::FabricTable &fabric_table, chip::FabricIndex fabric_index) override;
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+	void OnEnterActiveMode() override {}
+	void OnTransitionToIdle() override;
+	void OnEnterIdleMode() override {}
+	void OnICDModeChange() override {}
+#endif
+
+	// Writes the deferred records to settings when they are due, or always
+	void Flush(bool force);
+
+	// Writes to settings per day since the copy was filled
+	uint32_t WritesPerDay() const;
+
+private:
+	chip::PersistentStorageDelegate *backing = nullptr;
+	bool enabled = false;
+	uint32_t hits = 0;
+	uint32_t misses = 0;
+};
+
+#else
+
+class KvsCache {
+public:
+	CHIP_ERROR Init(chip::CommonCaseDeviceServerInitParams &params) { return CHIP_NO_ERROR; }
+	CHIP_ERROR Attach() { return CHIP_NO_ERROR; }
+	uint32_t WritesPerDay() const { return 0; }
+};
+
+#endif // CONFIG_APP_KVS_CACHE
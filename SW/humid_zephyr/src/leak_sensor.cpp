@@ -0,0 +1,137 @@
+#include "leak_sensor.h"
+
+#if CONFIG_APP_LEAK_SENSOR
+
+#include "trace.h"
+
+#include <app-common/zap-generated/attributes/Accessors.h>
+#include <app-common/zap-generated/cluster-objects.h>
+#include <app/EventLogging.h>
+#include <platform/CHIPDeviceLayer.h>
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+#include <app/icd/server/ICDNotifier.h>
+#endif
+
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+
+LOG_MODULE_REGISTER(leak_sensor, CONFIG_CHIP_APP_LOG_LEVEL);
+
+using namespace ::chip;
+using namespace ::chip::app::Clusters;
+using namespace ::chip::DeviceLayer;
+
+BUILD_ASSERT(DT_NODE_HAS_PROP(DT_PATH(zephyr_user), leak_gpios),
+	     "CONFIG_APP_LEAK_SENSOR needs leak-gpios in the zephyr,user node");
+
+namespace {
+
+const struct gpio_dt_spec probe = GPIO_DT_SPEC_GET(DT_PATH(zephyr_user), leak_gpios);
+struct gpio_callback probe_cb;
+
+LeakSensor *leak_sensor;
+
+// Set from the first edge until the settled state has been handled, so
+// bounces don't restart the latency trace
+atomic_t pending;
+
+void UpdateWork(intptr_t context)
+{
+	leak_sensor->Update();
+}
+
+// Runs in interrupt context, only hands over to the Matter thread
+void DebounceExpired(struct k_timer *timer)
+{
+	if (PlatformMgr().ScheduleWork(UpdateWork) != CHIP_NO_ERROR) {
+		// Event queue full, try again after another debounce period
+		k_timer_start(timer, K_MSEC(CONFIG_APP_LEAK_DEBOUNCE_MS), K_NO_WAIT);
+	}
+}
+
+K_TIMER_DEFINE(debounce, DebounceExpired, nullptr);
+
+void ProbeChanged(const struct device *port, struct gpio_callback *cb, gpio_port_pins_t pins)
+{
+	if (!atomic_test_and_set_bit(&pending, 0)) {
+		TraceBegin(TracePhase::kLeakReport);
+	}
+
+	k_timer_start(&debounce, K_MSEC(CONFIG_APP_LEAK_DEBOUNCE_MS), K_NO_WAIT);
+}
+
+} // namespace
+
+CHIP_ERROR LeakSensor::Init()
+{
+	int ret;
+
+	leak_sensor = this;
+
+	if (!gpio_is_ready_dt(&probe)) {
+		LOG_ERR("Leak probe GPIO not ready");
+		return CHIP_ERROR_INCORRECT_STATE;
+	}
+
+	ret = gpio_pin_configure_dt(&probe, GPIO_INPUT);
+	if (ret != 0) {
+		LOG_ERR("Failed to configure leak probe: %d", ret);
+		return CHIP_ERROR_INTERNAL;
+	}
+
+	wet = gpio_pin_get_dt(&probe) == 1;
+	BooleanState::Attributes::StateValue::Set(kEndpointId, wet);
+	if (wet) {
+		LOG_WRN("Leak detected at boot");
+	}
+
+	gpio_init_callback(&probe_cb, ProbeChanged, BIT(probe.pin));
+	gpio_add_callback_dt(&probe, &probe_cb);
+
+	ret = gpio_pin_interrupt_configure_dt(&probe, GPIO_INT_EDGE_BOTH);
+	if (ret != 0) {
+		LOG_ERR("Failed to arm leak probe interrupt: %d", ret);
+		return CHIP_ERROR_INTERNAL;
+	}
+
+	return CHIP_NO_ERROR;
+}
+
+void LeakSensor::Update()
+{
+	atomic_clear_bit(&pending, 0);
+
+	bool now_wet = gpio_pin_get_dt(&probe) == 1;
+
+	// Bounced back to where it was
+	if (now_wet == wet) {
+		return;
+	}
+
+	wet = now_wet;
+	LOG_INF("Leak %s", wet ? "detected" : "cleared");
+
+	BooleanState::Attributes::StateValue::Set(kEndpointId, wet);
+
+	BooleanState::Events::StateChange::Type event;
+	EventNumber number;
+
+	event.stateValue = wet;
+
+	if (app::LogEvent(event, kEndpointId, number) != CHIP_NO_ERROR) {
+		LOG_ERR("Failed to log StateChange event");
+	}
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+	// Fast poll while the report is delivered, the acknowledgement would
+	// otherwise sit at the parent until the next slow poll
+	app::ICDNotifier::GetInstance().NotifyNetworkActivityNotification();
+#endif
+
+	TraceEnd(TracePhase::kLeakReport);
+}
+
+#endif // CONFIG_APP_LEAK_SENSOR
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+
+// Water leak probe on endpoint 2, a Water Leak Detector with BooleanState.
+//
+// Two contacts between leak-gpios of the zephyr,user node and GND, water
+// bridging them pulls the pin active. The pin is watched with the GPIO port
+// SENSE mechanism, so waiting for a leak costs no current and needs no clock.
+//
+// A leak does not wait for the measurement scheduler: the edge starts a short
+// debounce timer, its expiry hands the new state straight to the Matter
+// thread, which sets StateValue, logs the StateChange event and puts the ICD
+// into active mode so the report and the controller's acknowledgement go out
+// without waiting for the next slow poll.
+class LeakSensor {
+public:
+	static constexpr chip::EndpointId kEndpointId = 2;
+
+#if CONFIG_APP_LEAK_SENSOR
+	CHIP_ERROR Init();
+
+	bool Wet() const { return wet; }
+
+	// Called on the Matter thread once the input settled after an edge
+	void Update();
+
+private:
+	bool wet = false;
+#else
+	CHIP_ERROR Init() { return CHIP_NO_ERROR; }
+
+	bool Wet() const { return false; }
+#endif // CONFIG_APP_LEAK_SENSOR
+};
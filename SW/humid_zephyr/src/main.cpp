@@ -1,13 +1,23 @@
 #include "app_task.h"
+#include "boot_resume.h"
+#include "storage_layout.h"
+#include "trace.h"
 
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/sys/printk.h>
 
+#include <stdlib.h>
+
 LOG_MODULE_REGISTER(app, CONFIG_CHIP_APP_LOG_LEVEL);
 
 int main()
 {
+	BootResumeInit();
+	StorageLayoutMigrate();
+	TraceInit();
+	TraceBegin(TracePhase::kBoot);
+
 	LOG_INF("Starting...");
 	CHIP_ERROR err = AppTask::StartApp();
 	LOG_ERR("Exited with code %" CHIP_ERROR_FORMAT, err.Format());
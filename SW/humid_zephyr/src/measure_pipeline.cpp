@@ -0,0 +1,95 @@
+#include "measure_pipeline.h"
+
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+#include <stdlib.h>
+
+LOG_MODULE_REGISTER(measure_pipeline, CONFIG_CHIP_APP_LOG_LEVEL);
+
+bool MeasurePipeline::Read(int16_t &temperature, uint16_t &humidity, bool stable, bool allow_heater)
+{
+	if (!sht4x.Ready()) {
+		LOG_DBG("Sht4x not ready");
+		return false;
+	}
+
+#if CONFIG_APP_SHT4X_DYNAMIC_REPEATABILITY
+	// Use the cheap conversion unless readings are moving or nothing was reported yet
+	if (reported && stable) {
+		auto repeatability = Sht4x::Repeatability::kLow;
+
+		if (!sht4x.Read(temperature, humidity, repeatability, allow_heater)) {
+			return false;
+		}
+		if (!NearReportThreshold(temperature, humidity, repeatability)) {
+			return true;
+		}
+		LOG_DBG("Close to report threshold, reading again at high repeatability");
+	}
+#endif
+
+	return sht4x.Read(temperature, humidity, Sht4x::Repeatability::kHigh, allow_heater);
+}
+
+void MeasurePipeline::Report(bool success, int16_t temperature, uint16_t humidity, AttributeSink &sink)
+{
+	if (!success) {
+		sink.SetNull();
+		Invalidate();
+		return;
+	}
+
+	if (TemperatureChanged(temperature)) {
+		sink.SetTemperature(temperature);
+		TemperatureReported(temperature);
+	}
+	if (HumidityChanged(humidity)) {
+		sink.SetHumidity(humidity);
+		HumidityReported(humidity);
+	}
+}
+
+bool MeasurePipeline::TemperatureChanged(int16_t temperature) const
+{
+	return !reported || abs(temperature - reported_temperature) >= CONFIG_APP_REPORT_TEMP_DELTA;
+}
+
+bool MeasurePipeline::HumidityChanged(uint16_t humidity) const
+{
+	return !reported || abs(humidity - reported_humidity) >= CONFIG_APP_REPORT_HUMIDITY_DELTA;
+}
+
+void MeasurePipeline::TemperatureReported(int16_t temperature)
+{
+	reported_temperature = temperature;
+	reported = true;
+}
+
+void MeasurePipeline::HumidityReported(uint16_t humidity)
+{
+	reported_humidity = humidity;
+	reported = true;
+}
+
+bool MeasurePipeline::NearReportThreshold(int16_t temperature, uint16_t humidity,
+					  Sht4x::Repeatability repeatability) const
+{
+	int temperature_margin = abs(abs(temperature - reported_temperature) - CONFIG_APP_REPORT_TEMP_DELTA);
+	int humidity_margin = abs(abs(humidity - reported_humidity) - CONFIG_APP_REPORT_HUMIDITY_DELTA);
+
+	return temperature_margin <= Sht4x::TemperatureNoise(repeatability) ||
+	       humidity_margin <= Sht4x::HumidityNoise(repeatability);
+}
+
+void MeasurePipeline::SaveCheckpoint(Checkpoint::State &checkpoint) const
+{
+	checkpoint.heater_pulses = MIN(sht4x.EnergyToday().heater_pulses, UINT16_MAX);
+}
+
+void MeasurePipeline::RestoreCheckpoint(const Checkpoint::State &checkpoint)
+{
+	// What was reported is not restored: after a cold boot the measured values
+	// start out null, the first reading has to be set whatever it is
+	sht4x.RestoreHeaterPulses(checkpoint.heater_pulses);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "attribute_sink.h"
+#include "checkpoint.h"
+#include "sht4x.h"
+
+#include <stdint.h>
+
+// Sensor side of a measurement: picks the SHT4x repeatability and decides
+// which readings changed enough to be worth a report. Has no Matter
+// dependencies, so the same code runs in the native_sim build.
+class MeasurePipeline {
+public:
+	explicit MeasurePipeline(Sht4x &sensor) : sht4x(sensor) {}
+
+	// Read at low repeatability while stable and far from a report threshold,
+	// at high repeatability otherwise. Fails when the sensor is not ready.
+	bool Read(int16_t &temperature, uint16_t &humidity, bool stable, bool allow_heater);
+
+	// Writes the readings that changed enough to the sink, or null when the
+	// read failed. On target with the Matter stack locked.
+	void Report(bool success, int16_t temperature, uint16_t humidity, AttributeSink &sink);
+
+	// Small changes are not reported, a report costs far more energy than a measurement
+	bool TemperatureChanged(int16_t temperature) const;
+	bool HumidityChanged(uint16_t humidity) const;
+
+	void TemperatureReported(int16_t temperature);
+	void HumidityReported(uint16_t humidity);
+
+	// The sensor failed and null was reported, the next reading is always reported
+	void Invalidate() { reported = false; }
+
+	void SaveCheckpoint(Checkpoint::State &checkpoint) const;
+	void RestoreCheckpoint(const Checkpoint::State &checkpoint);
+
+private:
+	// A low repeatability reading is only good enough when its noise can't flip
+	// the decision whether to report
+	bool NearReportThreshold(int16_t temperature, uint16_t humidity, Sht4x::Repeatability repeatability) const;
+
+	Sht4x &sht4x;
+
+	// Last values written to the measurement clusters
+	int16_t reported_temperature = 0;
+	uint16_t reported_humidity = 0;
+	bool reported = false;
+};
@@ -0,0 +1,212 @@
+#include "measure_scheduler.h"
+#include "diagnostics_cluster.h"
+#include "trace.h"
+
+#include <app/reporting/reporting.h>
+#include <app/server/Server.h>
+#include <lib/support/CodeUtils.h>
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+#include <app/icd/server/ICDConfigurationData.h>
+#include <app/icd/server/ICDManager.h>
+#endif
+
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_REGISTER(measure_scheduler, CONFIG_CHIP_APP_LOG_LEVEL);
+
+using namespace ::chip;
+using namespace ::chip::DeviceLayer;
+
+CHIP_ERROR MeasureScheduler::Init(k_work_handler_t measure_handler)
+{
+	k_work_init_delayable(&work, measure_handler);
+	interval.Init();
+
+	ReturnErrorOnFailure(PlatformMgr().AddEventHandler(ChipEventHandler, reinterpret_cast<intptr_t>(this)));
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+	// Returns nullptr once CHIP_CONFIG_ICD_OBSERVERS_POOL_SIZE observers are registered
+	VerifyOrReturnError(Server::GetInstance().GetICDManager().RegisterObserver(this) != nullptr, CHIP_ERROR_NO_MEMORY);
+#endif
+
+	// Nothing to report to until a controller has commissioned us,
+	// otherwise wait for kCommissioningComplete
+	if (Server::GetInstance().GetFabricTable().FabricCount() > 0) {
+		Start(500);
+	} else {
+		LOG_INF("Not commissioned, measurements will start once commissioned");
+	}
+
+	return CHIP_NO_ERROR;
+}
+
+void MeasureScheduler::Start(int64_t delay_ms)
+{
+	running = true;
+	ScheduleAt(k_uptime_get() + delay_ms);
+}
+
+void MeasureScheduler::Stop()
+{
+	running = false;
+	k_work_cancel_delayable(&work);
+}
+
+void MeasureScheduler::OnMeasured(bool success, int16_t temperature, uint16_t humidity)
+{
+	int64_t now = k_uptime_get();
+
+	if (success) {
+		uint32_t previous_sec = IntervalSec();
+
+		interval.Update(temperature, humidity, last_measure_ms > 0 ? now - last_measure_ms : 0);
+		if (IntervalSec() != previous_sec) {
+			MatterReportingAttributeChangeCallback(kRootEndpointId, HumidDiagnostics::Id,
+							       HumidDiagnostics::Attributes::MeasurementInterval::Id);
+		}
+	}
+
+	last_measure_ms = now;
+	measure_duration_ms = MAX(now - scheduled_ms, 0);
+
+	if (Server::GetInstance().GetFabricTable().FabricCount() == 0) {
+		LOG_INF("Last fabric removed, stopping measurements");
+		Stop();
+		return;
+	}
+
+	if (running) {
+		ScheduleAt(AlignToRadioWake(now + IntervalMs()));
+	}
+}
+
+void MeasureScheduler::OnBatterySampled(uint8_t battery_percent)
+{
+	if (policy.Update(battery_percent)) {
+		OnPolicyChanged();
+	}
+}
+
+void MeasureScheduler::OnSupplySampled(PowerPolicy::Level supply_level)
+{
+	if (policy.UpdateSupply(supply_level)) {
+		OnPolicyChanged();
+	}
+}
+
+void MeasureScheduler::SaveCheckpoint(Checkpoint::State &checkpoint) const
+{
+	checkpoint.interval_sec = interval.IntervalSec();
+	checkpoint.last_temperature = interval.LastTemperature();
+	checkpoint.last_humidity = interval.LastHumidity();
+	checkpoint.supply_level = static_cast<uint8_t>(policy.GetSupplyLevel());
+	if (interval.HasSample()) {
+		checkpoint.flags |= Checkpoint::kHasSample;
+	}
+}
+
+void MeasureScheduler::RestoreCheckpoint(const Checkpoint::State &checkpoint)
+{
+	interval.Restore(checkpoint.interval_sec, checkpoint.last_temperature, checkpoint.last_humidity,
+			 checkpoint.flags & Checkpoint::kHasSample);
+
+	// Start out as frugal as when the supply collapsed, until EnergyBudget says otherwise
+	policy.UpdateSupply(static_cast<PowerPolicy::Level>(
+		MIN(checkpoint.supply_level, static_cast<uint8_t>(PowerPolicy::Level::kSurvival))));
+
+	LOG_INF("Resumed from checkpoint, interval %u s", IntervalSec());
+}
+
+void MeasureScheduler::OnPolicyChanged()
+{
+	// The next measurement is scheduled by OnMeasured, the new slow poll
+	// interval applies from the next idle period
+	MatterReportingAttributeChangeCallback(kRootEndpointId, HumidDiagnostics::Id,
+					       HumidDiagnostics::Attributes::MeasurementInterval::Id);
+}
+
+void MeasureScheduler::ScheduleAt(int64_t when_ms)
+{
+	scheduled_ms = MAX(when_ms, k_uptime_get());
+	k_work_reschedule(&work, K_MSEC(scheduled_ms - k_uptime_get()));
+}
+
+int64_t MeasureScheduler::AlignToRadioWake(int64_t due_ms)
+{
+#if CONFIG_APP_MEASUREMENT_ICD_ALIGNMENT
+	// While in active mode the radio is already polling fast, nothing to align to
+	if (!icd_idle) {
+		return due_ms;
+	}
+
+	auto &icd = ICDConfigurationData::GetInstance();
+	int64_t slow_poll_ms = SlowPollMs();
+	int64_t idle_end_ms = idle_start_ms + System::Clock::Milliseconds64(icd.GetIdleModeDuration()).count();
+
+	// Due after this idle period ends, OnEnterIdleMode will realign it once
+	// the timing of the next idle period is known
+	if (due_ms >= idle_end_ms || slow_poll_ms <= 0) {
+		return due_ms;
+	}
+
+	// Slow polls are sent every slow_poll_ms from the start of idle mode,
+	// pick the first radio wake at or after the due time
+	int64_t polls = (due_ms - idle_start_ms + slow_poll_ms - 1) / slow_poll_ms;
+	int64_t wake_ms = MIN(idle_start_ms + polls * slow_poll_ms, idle_end_ms);
+
+	// Start early enough that the attributes are updated by the time the radio is up
+	return wake_ms - measure_duration_ms - CONFIG_APP_MEASUREMENT_ICD_LEAD_MS;
+#else
+	return due_ms;
+#endif
+}
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+void MeasureScheduler::OnEnterActiveMode()
+{
+	TraceBegin(TracePhase::kIcdActive);
+	icd_idle = false;
+
+	if (!running) {
+		return;
+	}
+
+	int64_t now = k_uptime_get();
+	int64_t due_ms = last_measure_ms + IntervalMs();
+	int64_t slow_poll_ms = SlowPollMs();
+
+	// Piggyback on this active period if the measurement would otherwise be
+	// due before the next slow poll. Not if one ran during this or the
+	// previous active period: its own report, a leak report or a keep-alive
+	// would then start a measurement on every wake.
+	if (due_ms - now <= slow_poll_ms && now - last_measure_ms >= slow_poll_ms) {
+		ScheduleAt(now);
+	} else {
+		ScheduleAt(due_ms);
+	}
+}
+
+void MeasureScheduler::OnEnterIdleMode()
+{
+	TraceEnd(TracePhase::kIcdActive);
+	icd_idle = true;
+	idle_start_ms = k_uptime_get();
+	policy.ApplySlowPoll();
+
+	if (running) {
+		ScheduleAt(AlignToRadioWake(last_measure_ms + IntervalMs()));
+	}
+}
+#endif
+
+void MeasureScheduler::ChipEventHandler(const ChipDeviceEvent *event, intptr_t arg)
+{
+	MeasureScheduler *scheduler = reinterpret_cast<MeasureScheduler *>(arg);
+
+	if (event->Type == DeviceEventType::kCommissioningComplete && !scheduler->running) {
+		LOG_INF("Commissioning complete, starting measurements");
+		scheduler->Start(500);
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "adaptive_interval.h"
+#include "checkpoint.h"
+#include "power_policy.h"
+
+#include <lib/core/CHIPError.h>
+#include <platform/CHIPDeviceLayer.h>
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+#include <app/icd/server/ICDStateObserver.h>
+#endif
+
+#include <zephyr/kernel.h>
+
+// Decides when the next measurement runs.
+//
+// Measurements only run once the device is commissioned. When ICD support is
+// enabled, each measurement is moved to just before the next expected radio
+// wake (a slow poll or the start of the next active period, where the LIT
+// check-in is sent) so the resulting report goes out while the radio is already
+// awake, instead of waking the SoC a second time.
+//
+// The interval itself comes from AdaptiveInterval, stretched by PowerPolicy as
+// the battery drains.
+//
+// Start/Stop/OnMeasured must be called with the CHIP stack locked.
+class MeasureScheduler
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+	: public chip::app::ICDStateObserver
+#endif
+{
+public:
+	CHIP_ERROR Init(k_work_handler_t measure_handler);
+
+	// Schedule the first measurement after delay_ms
+	void Start(int64_t delay_ms);
+	void Stop();
+
+	// Must be called at the end of every measurement to schedule the next one
+	void OnMeasured(bool success, int16_t temperature, uint16_t humidity);
+
+	// Feed a new battery reading to the power policy
+	void OnBatterySampled(uint8_t battery_percent);
+
+	// Feed the level decided by EnergyBudget to the power policy
+	void OnSupplySampled(PowerPolicy::Level supply_level);
+
+	// Schedule state for the brown-out checkpoint
+	void SaveCheckpoint(Checkpoint::State &checkpoint) const;
+
+	// Resume from a checkpoint, only when retained RAM was lost since it was written
+	void RestoreCheckpoint(const Checkpoint::State &checkpoint);
+
+	uint32_t IntervalSec() const { return policy.ScaleIntervalSec(interval.IntervalSec()); }
+	bool SignalStable() const { return interval.Stable(); }
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+	void OnEnterActiveMode() override;
+	void OnTransitionToIdle() override {}
+	void OnEnterIdleMode() override;
+	void OnICDModeChange() override {}
+#endif
+
+private:
+	static void ChipEventHandler(const chip::DeviceLayer::ChipDeviceEvent *event, intptr_t arg);
+
+	void OnPolicyChanged();
+	void ScheduleAt(int64_t when_ms);
+	int64_t AlignToRadioWake(int64_t due_ms);
+
+	int64_t IntervalMs() const { return IntervalSec() * 1000LL; }
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+	int64_t SlowPollMs() const { return policy.SlowPollInterval().count(); }
+#endif
+
+	struct k_work_delayable work;
+	bool running = false;
+	AdaptiveInterval interval;
+	PowerPolicy policy;
+
+	// k_uptime_get() timestamps, in ms
+	int64_t scheduled_ms = 0;
+	int64_t last_measure_ms = 0;
+	int64_t measure_duration_ms = 0;
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+	bool icd_idle = false;
+	int64_t idle_start_ms = 0;
+#endif
+};
@@ -0,0 +1,254 @@
+#include "ota_image_processor.h"
+#include "delta_patch.h"
+
+#include <platform/CHIPDeviceLayer.h>
+
+#if CONFIG_APP_OTA_FAST_TRANSFER
+#include <openthread/link.h>
+#if CONFIG_OPENTHREAD_RADIO_STATS
+#include <openthread/radio_stats.h>
+#endif
+#include <platform/ThreadStackManager.h>
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+#include <app/icd/server/ICDNotifier.h>
+#endif
+#endif // CONFIG_APP_OTA_FAST_TRANSFER
+
+#include <zephyr/devicetree.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+#if CONFIG_NRF_GRTC_TIMER
+#include <zephyr/drivers/timer/nrf_grtc_timer.h>
+#endif
+
+LOG_MODULE_REGISTER(ota_image_processor, CONFIG_CHIP_APP_LOG_LEVEL);
+
+using namespace ::chip;
+using namespace ::chip::DeviceLayer;
+
+// The GRTC keeps counting through a software reset, so the time from Apply()
+// to the new image starting can be measured across it
+#if CONFIG_NRF_GRTC_TIMER && CONFIG_CHIP_OTA_REQUESTOR_REBOOT_ON_APPLY
+
+#define APPLY_TIMING_NODE DT_NODELABEL(ota_apply_ram)
+#define APPLY_TIMING_ADDR (DT_REG_ADDR(DT_NODELABEL(retained_sram)) + DT_REG_ADDR(APPLY_TIMING_NODE))
+
+namespace {
+
+constexpr uint32_t kApplyMagic = 0x4f544131; // "OTA1"
+
+struct ApplyTiming {
+	uint32_t magic;
+	uint32_t reboot_delay_ms;
+	uint64_t apply_us;
+};
+
+static_assert(sizeof(ApplyTiming) <= DT_REG_SIZE(APPLY_TIMING_NODE), "Apply timing does not fit ota_apply_ram");
+
+ApplyTiming *const apply_timing = reinterpret_cast<ApplyTiming *>(APPLY_TIMING_ADDR);
+
+} // namespace
+
+void AppOTAImageProcessor::ReportBootTime()
+{
+	if (apply_timing->magic != kApplyMagic) {
+		return;
+	}
+
+	apply_timing->magic = 0;
+
+	uint64_t now_us = z_nrf_grtc_timer_read();
+
+	// The GRTC was reset along with everything else, nothing to compare with
+	if (now_us < apply_timing->apply_us) {
+		return;
+	}
+
+	uint32_t elapsed_ms = static_cast<uint32_t>((now_us - apply_timing->apply_us) / USEC_PER_MSEC);
+	uint32_t delay_ms = MIN(elapsed_ms, apply_timing->reboot_delay_ms);
+
+	LOG_INF("Booted %u ms after OTA apply: %u ms reboot delay, %u ms reset, MCUboot and kernel start", elapsed_ms,
+		delay_ms, elapsed_ms - delay_ms);
+}
+
+#else
+
+void AppOTAImageProcessor::ReportBootTime() {}
+
+#endif // CONFIG_NRF_GRTC_TIMER && CONFIG_CHIP_OTA_REQUESTOR_REBOOT_ON_APPLY
+
+CHIP_ERROR AppOTAImageProcessor::PrepareDownload()
+{
+	VerifyOrReturnError(mDownloader != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+	TriggerFlashAction(ExternalFlashManager::Action::WAKE_UP);
+
+	return SystemLayer().ScheduleLambda([this] {
+		CHIP_ERROR err = PrepareDownloadImpl();
+
+		// dfu_multi_image_init() in PrepareDownloadImpl() drops all writers, the
+		// patch writer goes next to the full image ones
+		if (err == CHIP_NO_ERROR && DeltaPatchRegisterWriter() != 0) {
+			LOG_ERR("Failed to register delta patch writer");
+			err = CHIP_ERROR_INTERNAL;
+		}
+
+#if CONFIG_APP_OTA_FAST_TRANSFER
+		if (err == CHIP_NO_ERROR) {
+			BeginTransfer();
+		}
+#endif
+
+		mDownloader->OnPreparedForDownload(err);
+	});
+}
+
+CHIP_ERROR AppOTAImageProcessor::ProcessBlock(ByteSpan &block)
+{
+	last_block_ms = k_uptime_get();
+
+#if CONFIG_APP_OTA_FAST_TRANSFER
+	// Counted before the OTA header is taken off the first block
+	bytes += block.size();
+	blocks++;
+#endif
+
+	return OTAImageProcessorImpl::ProcessBlock(block);
+}
+
+CHIP_ERROR AppOTAImageProcessor::Finalize()
+{
+	// Writes what is left of the image and checks it
+	CHIP_ERROR err = OTAImageProcessorImpl::Finalize();
+
+	if (err == CHIP_NO_ERROR) {
+		LOG_INF("OTA image written %u ms after the last block",
+			static_cast<uint32_t>(k_uptime_get() - last_block_ms));
+	}
+
+#if CONFIG_APP_OTA_FAST_TRANSFER
+	EndTransfer(err == CHIP_NO_ERROR);
+#endif
+
+	// Not needed again until Apply(), which may be a long way off
+	TriggerFlashAction(ExternalFlashManager::Action::SLEEP);
+
+	return err;
+}
+
+CHIP_ERROR AppOTAImageProcessor::Apply()
+{
+	// Scheduling the update writes the swap request into the secondary slot
+	TriggerFlashAction(ExternalFlashManager::Action::WAKE_UP);
+
+	CHIP_ERROR err = OTAImageProcessorImpl::Apply();
+
+	TriggerFlashAction(ExternalFlashManager::Action::SLEEP);
+
+	if (err != CHIP_NO_ERROR) {
+		return err;
+	}
+
+	// Includes waiting for the provider to allow the update
+	LOG_INF("OTA reboot ready %u ms after the last block", static_cast<uint32_t>(k_uptime_get() - last_block_ms));
+
+#if CONFIG_NRF_GRTC_TIMER && CONFIG_CHIP_OTA_REQUESTOR_REBOOT_ON_APPLY
+	apply_timing->reboot_delay_ms = CHIP_DEVICE_CONFIG_OTA_REQUESTOR_REBOOT_DELAY_MS;
+	apply_timing->apply_us = z_nrf_grtc_timer_read();
+	apply_timing->magic = kApplyMagic;
+#endif
+
+	return err;
+}
+
+CHIP_ERROR AppOTAImageProcessor::Abort()
+{
+#if CONFIG_APP_OTA_FAST_TRANSFER
+	EndTransfer(false);
+#endif
+
+	CHIP_ERROR err = OTAImageProcessorImpl::Abort();
+
+	TriggerFlashAction(ExternalFlashManager::Action::SLEEP);
+
+	return err;
+}
+
+#if CONFIG_APP_OTA_FAST_TRANSFER
+
+AppOTAImageProcessor::RadioCounters AppOTAImageProcessor::SampleRadio()
+{
+	RadioCounters counters = {};
+
+	ThreadStackMgr().LockThreadStack();
+
+	otInstance *instance = ThreadStackMgrImpl().OTInstance();
+	const otMacCounters *mac = otLinkGetCounters(instance);
+
+	counters.tx_frames = mac->mTxTotal;
+	counters.tx_retries = mac->mTxRetry;
+	counters.tx_failed = mac->mTxErrAbort + mac->mTxErrBusyChannel + mac->mTxErrCca + mac->mTxDirectMaxRetryExpiry;
+	counters.rx_frames = mac->mRxTotal;
+
+#if CONFIG_OPENTHREAD_RADIO_STATS
+	const otRadioTimeStats *time = otRadioTimeStatsGet(instance);
+
+	counters.tx_us = time->mTxTime;
+	counters.rx_us = time->mRxTime;
+#endif
+
+	ThreadStackMgr().UnlockThreadStack();
+
+	return counters;
+}
+
+void AppOTAImageProcessor::BeginTransfer()
+{
+	transferring = true;
+	start_ms = k_uptime_get();
+	bytes = 0;
+	blocks = 0;
+	radio_start = SampleRadio();
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+	// Released in EndTransfer(), the ICD then falls back to slow polling by itself
+	app::ICDNotifier::GetInstance().NotifyActiveRequestNotification(
+		app::ICDListener::KeepActiveFlag::kExchangeContextOpen);
+#endif
+
+	LOG_INF("OTA download started, fast polling until it ends");
+}
+
+void AppOTAImageProcessor::EndTransfer(bool success)
+{
+	if (!transferring) {
+		return;
+	}
+
+	transferring = false;
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+	app::ICDNotifier::GetInstance().NotifyActiveRequestWithdrawal(
+		app::ICDListener::KeepActiveFlag::kExchangeContextOpen);
+#endif
+
+	RadioCounters radio = SampleRadio();
+	uint32_t elapsed_ms = static_cast<uint32_t>(k_uptime_get() - start_ms);
+	uint32_t rate = elapsed_ms > 0 ? static_cast<uint32_t>(uint64_t(bytes) * MSEC_PER_SEC / elapsed_ms) : 0;
+
+	LOG_INF("OTA download %s: %u bytes in %u blocks, %u.%03u s, %u B/s", success ? "done" : "aborted", bytes,
+		blocks, elapsed_ms / MSEC_PER_SEC, elapsed_ms % MSEC_PER_SEC, rate);
+	LOG_INF("OTA radio: %u frames sent, %u MAC retries, %u failed, %u received",
+		radio.tx_frames - radio_start.tx_frames, radio.tx_retries - radio_start.tx_retries,
+		radio.tx_failed - radio_start.tx_failed, radio.rx_frames - radio_start.rx_frames);
+#if CONFIG_OPENTHREAD_RADIO_STATS
+	LOG_INF("OTA radio on: %u ms transmitting, %u ms receiving",
+		static_cast<uint32_t>((radio.tx_us - radio_start.tx_us) / USEC_PER_MSEC),
+		static_cast<uint32_t>((radio.rx_us - radio_start.rx_us) / USEC_PER_MSEC));
+#endif
+}
+
+#endif // CONFIG_APP_OTA_FAST_TRANSFER
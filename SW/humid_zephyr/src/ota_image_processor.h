@@ -0,0 +1,58 @@
+#pragma once
+
+#include <platform/nrfconnect/OTAImageProcessorImpl.h>
+
+#include <stdint.h>
+
+// Image processor that also accepts delta OTA images, see delta_patch.h.
+//
+// With CONFIG_APP_OTA_FAST_TRANSFER the ICD is held in active mode from
+// PrepareDownload() until Finalize() or Abort(), so every BDX block query
+// goes out at the fast poll interval instead of waiting for a slow poll.
+// Throughput and the radio cost of each download are logged at the end.
+//
+// The external flash handler, see flash_power.h, is woken for the download
+// and for Apply() only. It goes back to sleep as soon as the image is
+// written, while the requestor waits for the provider to allow the update.
+//
+// The time from the last block to the image being written and to Apply()
+// scheduling the reboot is logged. The moment of Apply() is kept in retained
+// RAM, ReportBootTime() logs how long the reboot through MCUboot took.
+class AppOTAImageProcessor : public chip::DeviceLayer::OTAImageProcessorImpl {
+public:
+	using OTAImageProcessorImpl::OTAImageProcessorImpl;
+
+	// Call first thing after boot, logs the reboot time if an update was applied
+	static void ReportBootTime();
+
+	CHIP_ERROR PrepareDownload() override;
+	CHIP_ERROR ProcessBlock(chip::ByteSpan &block) override;
+	CHIP_ERROR Finalize() override;
+	CHIP_ERROR Apply() override;
+	CHIP_ERROR Abort() override;
+
+private:
+	int64_t last_block_ms;
+
+#if CONFIG_APP_OTA_FAST_TRANSFER
+	struct RadioCounters {
+		uint32_t tx_frames;
+		uint32_t tx_retries;
+		uint32_t tx_failed;
+		uint32_t rx_frames;
+		uint64_t tx_us;
+		uint64_t rx_us;
+	};
+
+	static RadioCounters SampleRadio();
+
+	void BeginTransfer();
+	void EndTransfer(bool success);
+
+	bool transferring = false;
+	int64_t start_ms;
+	uint32_t bytes;
+	uint32_t blocks;
+	RadioCounters radio_start;
+#endif // CONFIG_APP_OTA_FAST_TRANSFER
+};
@@ -0,0 +1,38 @@
+#include "ota_requestor_driver.h"
+#include "footprint.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(ota_requestor_driver, CONFIG_CHIP_APP_LOG_LEVEL);
+
+void AppOTARequestorDriver::SendQueryImage()
+{
+	if (!energy_budget.Plentiful()) {
+		LOG_INF("Energy budget short, deferring OTA query");
+		query_deferred = true;
+		return;
+	}
+
+	query_deferred = false;
+	DefaultOTARequestorDriver::SendQueryImage();
+}
+
+void AppOTARequestorDriver::OnEnergySampled()
+{
+	if (query_deferred && energy_budget.Plentiful()) {
+		LOG_INF("Energy budget recovered, sending deferred OTA query");
+		SendQueryImage();
+	}
+}
+
+void AppOTARequestorDriver::HandleIdleStateExit()
+{
+	FootprintEnterPhase(FootprintPhase::kOta);
+	DefaultOTARequestorDriver::HandleIdleStateExit();
+}
+
+void AppOTARequestorDriver::HandleIdleStateEnter(IdleStateReason reason)
+{
+	DefaultOTARequestorDriver::HandleIdleStateEnter(reason);
+	FootprintEnterPhase(FootprintPhase::kSteady);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "energy_budget.h"
+
+#include <app/clusters/ota-requestor/DefaultOTARequestorDriver.h>
+#include <transport/raw/MessageHeader.h>
+
+// OTA requestor driver that holds back queries while harvested energy is
+// short. A query that finds an update starts a download right away, which
+// keeps the radio busy for minutes, so deferred queries are sent once the
+// energy budget is plentiful again.
+class AppOTARequestorDriver : public chip::DeviceLayer::DefaultOTARequestorDriver {
+public:
+	explicit AppOTARequestorDriver(const EnergyBudget &budget) : energy_budget(budget)
+	{
+#if CONFIG_APP_OTA_FAST_TRANSFER
+		SetMaxDownloadBlockSize(kMaxDownloadBlockSize);
+#endif
+	}
+
+	void SendQueryImage() override;
+
+	// OTA memory use is tracked from leaving idle until returning to it
+	void HandleIdleStateExit() override;
+	void HandleIdleStateEnter(IdleStateReason reason) override;
+
+	// Must be called with the CHIP stack locked whenever the energy budget is sampled
+	void OnEnergySampled();
+
+private:
+	// Largest BDX block a message over UDP carries, the 4 byte block counter
+	// takes the rest. Every block costs a round trip, the provider may still
+	// pick a smaller size.
+	static constexpr uint16_t kMaxDownloadBlockSize = chip::kMaxAppMessageLen - 4;
+
+	const EnergyBudget &energy_budget;
+	bool query_deferred = false;
+};
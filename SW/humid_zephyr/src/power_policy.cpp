@@ -0,0 +1,128 @@
+#include "power_policy.h"
+
+#include <platform/CHIPDeviceLayer.h>
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+#include <app/icd/server/ICDConfigurationData.h>
+#endif
+
+#include <zephyr/logging/log.h>
+
+#include <algorithm>
+
+LOG_MODULE_REGISTER(power_policy, CONFIG_CHIP_APP_LOG_LEVEL);
+
+using namespace ::chip;
+using namespace ::chip::DeviceLayer;
+
+namespace {
+
+// A level is only left once the battery is this much above its threshold,
+// so voltage noise around a threshold doesn't toggle the intervals
+constexpr uint8_t kHysteresisPercent = 5;
+
+} // namespace
+
+bool PowerPolicy::Update(uint8_t battery_percent)
+{
+#if CONFIG_APP_POWER_POLICY
+	Level level = battery_level;
+	Level new_level = level;
+
+	if (battery_percent <= CONFIG_APP_POWER_POLICY_CRITICAL_PERCENT) {
+		new_level = Level::kCritical;
+	} else if (battery_percent <= CONFIG_APP_POWER_POLICY_LOW_PERCENT) {
+		if (level != Level::kCritical ||
+		    battery_percent > CONFIG_APP_POWER_POLICY_CRITICAL_PERCENT + kHysteresisPercent) {
+			new_level = Level::kLow;
+		}
+	} else if (level == Level::kNormal ||
+		   battery_percent > CONFIG_APP_POWER_POLICY_LOW_PERCENT + kHysteresisPercent) {
+		new_level = Level::kNormal;
+	}
+
+	if (new_level == level) {
+		return false;
+	}
+
+	LOG_INF("Battery at %u%%, power level %d -> %d", battery_percent, static_cast<int>(level),
+		static_cast<int>(new_level));
+
+	Level previous = GetLevel();
+	battery_level = new_level;
+
+	return GetLevel() != previous;
+#else
+	return false;
+#endif
+}
+
+bool PowerPolicy::UpdateSupply(Level level)
+{
+	Level previous = GetLevel();
+
+	supply_level = level;
+
+	return GetLevel() != previous;
+}
+
+uint32_t PowerPolicy::ScaleIntervalSec(uint32_t interval_sec) const
+{
+#if CONFIG_APP_ENERGY_HARVEST
+	if (GetLevel() == Level::kSurvival) {
+		return MAX(interval_sec, CONFIG_APP_HARVEST_SURVIVAL_INTERVAL_SEC);
+	}
+#endif
+
+	return interval_sec * Scale();
+}
+
+uint32_t PowerPolicy::Scale() const
+{
+	switch (GetLevel()) {
+#if CONFIG_APP_POWER_POLICY
+	case Level::kLow:
+		return CONFIG_APP_POWER_POLICY_LOW_SCALE;
+	case Level::kCritical:
+	case Level::kSurvival:
+		return CONFIG_APP_POWER_POLICY_CRITICAL_SCALE;
+#endif
+	default:
+		return 1;
+	}
+}
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+System::Clock::Milliseconds32 PowerPolicy::SlowPollInterval() const
+{
+	auto &icd = ICDConfigurationData::GetInstance();
+	System::Clock::Milliseconds32 slow_poll = icd.GetSlowPollingInterval();
+
+	if (icd.GetICDMode() != ICDConfigurationData::ICDMode::LIT) {
+		return slow_poll;
+	}
+
+	// Polling less often than the check-ins would gain nothing
+	System::Clock::Milliseconds32 idle_duration = icd.GetIdleModeDuration();
+
+	if (GetLevel() == Level::kSurvival) {
+		return idle_duration;
+	}
+
+	return std::min(slow_poll * Scale(), idle_duration);
+}
+
+void PowerPolicy::ApplySlowPoll() const
+{
+	System::Clock::Milliseconds32 slow_poll = SlowPollInterval();
+
+	if (slow_poll == ICDConfigurationData::GetInstance().GetSlowPollingInterval()) {
+		return;
+	}
+
+	CHIP_ERROR err = ConnectivityMgr().SetPollingInterval(slow_poll);
+	if (err != CHIP_NO_ERROR) {
+		LOG_ERR("Failed to set slow poll interval: %" CHIP_ERROR_FORMAT, err.Format());
+	}
+}
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <system/SystemClock.h>
+
+#include <zephyr/sys/util.h>
+
+#include <stdint.h>
+
+// Battery and energy harvest aware duty cycling.
+//
+// As the battery drains the measurement interval is multiplied by
+// CONFIG_APP_POWER_POLICY_LOW_SCALE and then CONFIG_APP_POWER_POLICY_CRITICAL_SCALE,
+// and so is the ICD slow poll interval while operating as a LIT ICD. SIT
+// devices keep their slow poll, clients rely on it to reach the device.
+//
+// On energy harvesting nodes EnergyBudget sets the supply level, the lower
+// of the two levels wins. In survival the device only measures every
+// CONFIG_APP_HARVEST_SURVIVAL_INTERVAL_SEC and polls once per idle period.
+class PowerPolicy {
+public:
+	enum class Level : uint8_t {
+		kNormal,
+		kLow,
+		kCritical,
+		kSurvival,
+	};
+
+	// Feed a new battery reading, returns true when the level changed
+	bool Update(uint8_t battery_percent);
+
+	// Feed the level decided by EnergyBudget, returns true when the level changed
+	bool UpdateSupply(Level supply_level);
+
+	Level GetLevel() const { return MAX(battery_level, supply_level); }
+	Level GetSupplyLevel() const { return supply_level; }
+
+	uint32_t ScaleIntervalSec(uint32_t interval_sec) const;
+
+#if CHIP_CONFIG_ENABLE_ICD_SERVER
+	// Slow poll interval to use while in idle mode
+	chip::System::Clock::Milliseconds32 SlowPollInterval() const;
+
+	// Must be called on entering idle mode, after the ICD manager set the default slow poll
+	void ApplySlowPoll() const;
+#endif
+
+private:
+	uint32_t Scale() const;
+
+	Level battery_level = Level::kNormal;
+	Level supply_level = Level::kNormal;
+};
@@ -0,0 +1,27 @@
+#include "reset_cause.h"
+
+#if CONFIG_HWINFO
+
+#include <zephyr/drivers/hwinfo.h>
+#include <zephyr/init.h>
+
+namespace {
+
+uint32_t reset_cause;
+
+int CaptureResetCause()
+{
+	hwinfo_get_reset_cause(&reset_cause);
+	return 0;
+}
+
+SYS_INIT(CaptureResetCause, POST_KERNEL, 0);
+
+} // namespace
+
+uint32_t ResetCause()
+{
+	return reset_cause;
+}
+
+#endif // CONFIG_HWINFO
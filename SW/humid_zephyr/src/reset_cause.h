@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+
+// Reset cause of this boot, as hwinfo RESET_* flags. Captured at
+// POST_KERNEL init, the Matter stack clears the register when it starts.
+// The nRF54L has no power-on reset flag, a power-on reset leaves 0.
+#if CONFIG_HWINFO
+uint32_t ResetCause();
+#else
+inline uint32_t ResetCause()
+{
+	return 0;
+}
+#endif // CONFIG_HWINFO
@@ -0,0 +1,66 @@
+#include "sample_encoder.h"
+
+#include <zephyr/sys/util.h>
+
+#include <stdlib.h>
+
+namespace {
+
+// The ICD alignment moves a measurement by a second or so. Smaller deviations
+// from the previous interval are not worth an explicit dt, the decoded time
+// stays within this of the real one.
+constexpr int32_t kTimeSlackSec = 2;
+
+uint32_t ZigZag(int32_t value)
+{
+	return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+} // namespace
+
+size_t SampleEncoder::PutVarint(uint8_t *out, uint32_t value)
+{
+	size_t length = 0;
+
+	while (value >= 0x80) {
+		out[length++] = static_cast<uint8_t>(value) | 0x80;
+		value >>= 7;
+	}
+	out[length++] = static_cast<uint8_t>(value);
+
+	return length;
+}
+
+void SampleEncoder::Start(uint32_t time_s, int16_t temperature, uint16_t humidity)
+{
+	state = {
+		.time_s = time_s,
+		.interval_s = 0,
+		.temperature = temperature,
+		.humidity = humidity,
+	};
+	next = state;
+}
+
+size_t SampleEncoder::Encode(uint32_t time_s, int16_t temperature, uint16_t humidity, uint8_t *out)
+{
+	size_t length = 0;
+	int32_t elapsed = static_cast<int32_t>(time_s - state.time_s);
+	bool has_dt = abs(elapsed - state.interval_s) > kTimeSlackSec;
+
+	next = state;
+
+	length += PutVarint(out + length, ZigZag(temperature - state.temperature) << 1 | has_dt);
+	if (has_dt) {
+		// The series may run ahead of time_s by the slack, never step back
+		next.interval_s = MAX(elapsed, 0);
+		length += PutVarint(out + length, next.interval_s);
+	}
+	length += PutVarint(out + length, ZigZag(humidity - state.humidity));
+
+	next.time_s += next.interval_s;
+	next.temperature = temperature;
+	next.humidity = humidity;
+
+	return length;
+}
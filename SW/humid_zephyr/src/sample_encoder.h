@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Delta encoding of a series of temperature/humidity samples, used by the
+// sample log blocks and the Samples attribute of Humid Samples. The first
+// sample is stored absolute by the user, every following one is a record
+//   varint(zigzag(dT) << 1 | has_dt) [varint(dt)] varint(zigzag(dH))
+// with dT in 0.01 °C and dH in 0.01 %RH. dt in seconds is only written when
+// the interval changes, otherwise it repeats the previous one. Steady
+// readings take two bytes per sample.
+class SampleEncoder {
+public:
+	// Longest record, a full dt and the largest dT and dH
+	static constexpr size_t kMaxRecordSize = 11;
+
+	static size_t PutVarint(uint8_t *out, uint32_t value);
+
+	// Starts a series at the absolute first sample
+	void Start(uint32_t time_s, int16_t temperature, uint16_t humidity);
+
+	// Encodes the next sample into out and returns the record length. The
+	// series only moves on with Commit(), so a record that does not fit can
+	// be dropped.
+	size_t Encode(uint32_t time_s, int16_t temperature, uint16_t humidity, uint8_t *out);
+	void Commit() { state = next; }
+
+private:
+	// As the decoder reconstructs it
+	struct State {
+		uint32_t time_s;
+		int32_t interval_s;
+		int16_t temperature;
+		uint16_t humidity;
+	};
+
+	State state = {};
+	State next = {};
+};
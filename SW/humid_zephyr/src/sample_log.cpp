@@ -0,0 +1,470 @@
+#include "sample_log.h"
+
+#if CONFIG_APP_SAMPLE_LOG
+
+#include "sample_encoder.h"
+
+#include <app/clusters/diagnostic-logs-server/DiagnosticLogsProviderDelegate.h>
+#include <app/clusters/diagnostic-logs-server/diagnostic-logs-server.h>
+#include <lib/support/CodeUtils.h>
+#include <platform/CHIPDeviceLayer.h>
+
+#include <pm_config.h>
+
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/pm/device_runtime.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/util.h>
+
+#include <string.h>
+
+LOG_MODULE_REGISTER(sample_log, CONFIG_CHIP_APP_LOG_LEVEL);
+
+using namespace ::chip;
+using namespace ::chip::app::Clusters::DiagnosticLogs;
+using namespace ::chip::DeviceLayer;
+
+#define TAIL_NODE DT_NODELABEL(sample_log_ram)
+#define TAIL_ADDR (DT_REG_ADDR(DT_NODELABEL(retained_sram)) + DT_REG_ADDR(TAIL_NODE))
+
+#define RRAM_WRITE_BLOCK_SIZE DT_PROP(DT_CHOSEN(zephyr_flash), write_block_size)
+
+namespace {
+
+constexpr size_t kWordSize = 16;
+constexpr size_t kBlockSize = 256;
+constexpr uint32_t kBlockCount = PM_SAMPLE_LOG_SIZE / kBlockSize;
+
+// Smallest erase of the external SPI NOR flash
+constexpr size_t kSectorSize = 4096;
+constexpr uint32_t kBlocksPerSector = kSectorSize / kBlockSize;
+
+constexpr uint16_t kMagic = 0x534c;         // "SL"
+constexpr uint32_t kTailMagic = 0x534c5431; // "SLT1"
+
+constexpr LogSessionHandle kSessionHandle = 1;
+
+static_assert(kWordSize % RRAM_WRITE_BLOCK_SIZE == 0, "Staged word must be whole RRAM write blocks");
+static_assert(kBlockCount >= 2, "sample_log partition too small");
+static_assert(PM_SAMPLE_LOG_SIZE % kSectorSize == 0, "sample_log must be whole flash sectors");
+
+struct BlockHeader {
+	uint32_t sequence;
+	uint32_t uptime_s; // of the first sample
+	uint16_t magic;
+	uint16_t boot;
+	int16_t temperature;
+	uint16_t humidity;
+};
+
+static_assert(sizeof(BlockHeader) == kWordSize, "Block header must be one staged word");
+
+// Word being filled, in retained RAM so a reset does not lose it
+struct Tail {
+	uint32_t magic;
+	uint32_t sequence; // block the word belongs to
+	uint16_t offset;   // of the word in its block
+	uint8_t used;
+	uint8_t reserved;
+	uint8_t word[kWordSize];
+};
+
+static_assert(sizeof(Tail) <= DT_REG_SIZE(TAIL_NODE), "Staged word does not fit sample_log_ram");
+
+Tail *const tail = reinterpret_cast<Tail *>(TAIL_ADDR);
+
+const struct flash_area *area;
+// Set when the partition is on flash that must be erased before a write
+bool explicit_erase;
+uint16_t boot;
+
+bool have_blocks;
+uint32_t newest;
+
+bool block_open;
+SampleEncoder encoder;
+
+// Append cost, see SampleLog::Append()
+uint32_t words_written;
+uint32_t slowest_append_us;
+
+// Keeps the external flash out of deep power-down while the log is accessed,
+// a no-op for RRAM. Appends that only stage a record leave it asleep.
+class Awake {
+public:
+	Awake() { pm_device_runtime_get(area->fa_dev); }
+	~Awake() { pm_device_runtime_put(area->fa_dev); }
+};
+
+off_t BlockOffset(uint32_t sequence)
+{
+	return (sequence % kBlockCount) * kBlockSize;
+}
+
+bool Read(off_t offset, void *out, size_t length)
+{
+	int ret = flash_area_read(area, offset, out, length);
+
+	if (ret != 0) {
+		LOG_ERR("Failed to read sample log: %d", ret);
+		return false;
+	}
+
+	return true;
+}
+
+bool BlockValid(uint32_t sequence)
+{
+	BlockHeader header;
+
+	return Read(BlockOffset(sequence), &header, sizeof(header)) && header.magic == kMagic &&
+	       header.sequence == sequence;
+}
+
+uint32_t Oldest()
+{
+	return newest >= kBlockCount ? newest - kBlockCount + 1 : 0;
+}
+
+uint32_t Uptime()
+{
+	return static_cast<uint32_t>(k_uptime_get() / MSEC_PER_SEC);
+}
+
+bool WriteWord(uint32_t sequence, size_t offset, const void *word)
+{
+	Awake awake;
+	int ret = flash_area_write(area, BlockOffset(sequence) + offset, word, kWordSize);
+
+	if (ret != 0) {
+		LOG_ERR("Failed to write sample log: %d", ret);
+		return false;
+	}
+
+	words_written++;
+
+	return true;
+}
+
+// Writes out a partly filled word. The rest of the word and of its block stay
+// erased, which the decoder takes as the end of the block.
+void FlushTail()
+{
+	if (tail->used == 0) {
+		return;
+	}
+
+	memset(tail->word + tail->used, 0xff, kWordSize - tail->used);
+	WriteWord(tail->sequence, tail->offset, tail->word);
+	tail->offset += kWordSize;
+	tail->used = 0;
+}
+
+void OpenBlock(uint32_t now, int16_t temperature, uint16_t humidity)
+{
+	Awake awake;
+	uint32_t sequence = have_blocks ? newest + 1 : 0;
+	uint8_t erased[kWordSize];
+	uint8_t word[kWordSize];
+
+	memset(erased, 0xff, sizeof(erased));
+
+	if (explicit_erase) {
+		// NOR flash erases whole sectors, the first block of a sector
+		// drops the previous pass of the next 15 with it
+		if (sequence % kBlocksPerSector == 0) {
+			int ret = flash_area_erase(area, BlockOffset(sequence), kSectorSize);
+
+			if (ret != 0) {
+				LOG_ERR("Failed to erase sample log: %d", ret);
+				return;
+			}
+		}
+	} else {
+		// RRAM needs no erase, the previous pass is overwritten with the
+		// erased value starting with its header, so a reset midway leaves no
+		// valid block. Once the ring wrapped that is up to 16 word writes,
+		// plus the header.
+		for (size_t offset = 0; offset < kBlockSize; offset += kWordSize) {
+			if (!Read(BlockOffset(sequence) + offset, word, kWordSize)) {
+				return;
+			}
+			if (memcmp(word, erased, kWordSize) != 0 && !WriteWord(sequence, offset, erased)) {
+				return;
+			}
+		}
+	}
+
+	BlockHeader header = {
+		.sequence = sequence,
+		.uptime_s = now,
+		.magic = kMagic,
+		.boot = boot,
+		.temperature = temperature,
+		.humidity = humidity,
+	};
+
+	if (!WriteWord(sequence, 0, &header)) {
+		return;
+	}
+
+	newest = sequence;
+	have_blocks = true;
+
+	tail->magic = kTailMagic;
+	tail->sequence = sequence;
+	tail->offset = kWordSize;
+	tail->used = 0;
+
+	block_open = true;
+	encoder.Start(now, temperature, humidity);
+}
+
+// Encodes the sample into the staged word, writes it out once full
+void Store(uint32_t now, int16_t temperature, uint16_t humidity)
+{
+	if (!block_open) {
+		OpenBlock(now, temperature, humidity);
+		return;
+	}
+
+	uint8_t record[SampleEncoder::kMaxRecordSize];
+	size_t length = encoder.Encode(now, temperature, humidity, record);
+
+	if (tail->offset + tail->used + length > kBlockSize) {
+		FlushTail();
+		OpenBlock(now, temperature, humidity);
+		return;
+	}
+
+	encoder.Commit();
+
+	for (size_t i = 0; i < length; i++) {
+		tail->word[tail->used++] = record[i];
+
+		if (tail->used == kWordSize) {
+			if (!WriteWord(tail->sequence, tail->offset, tail->word)) {
+				// Keep the decodable part, start over with absolute values
+				tail->used = 0;
+				block_open = false;
+				return;
+			}
+			tail->offset += kWordSize;
+			tail->used = 0;
+		}
+	}
+}
+
+// Copies part of a block as it is exported, the staged word included
+void ReadBlock(uint32_t sequence, size_t offset, uint8_t *out, size_t length)
+{
+	if (!Read(BlockOffset(sequence) + offset, out, length)) {
+		memset(out, 0xff, length);
+	}
+
+	if (tail->magic != kTailMagic || tail->sequence != sequence || tail->used == 0) {
+		return;
+	}
+
+	size_t begin = MAX(offset, tail->offset);
+	size_t end = MIN(offset + length, static_cast<size_t>(tail->offset + tail->used));
+
+	if (begin < end) {
+		memcpy(out + (begin - offset), tail->word + (begin - tail->offset), end - begin);
+	}
+}
+
+// Serves the log for the EndUserSupport intent. Blocks are exported whole from
+// oldest to newest, the decoder sorts them by sequence.
+class Provider : public DiagnosticLogsProviderDelegate {
+public:
+	CHIP_ERROR StartLogCollection(IntentEnum intent, LogSessionHandle &outHandle, Optional<uint64_t> &outTimeStamp,
+				      Optional<uint64_t> &outTimeSinceBoot) override
+	{
+		VerifyOrReturnError(intent == IntentEnum::kEndUserSupport && have_blocks, CHIP_ERROR_NOT_FOUND);
+		VerifyOrReturnError(!session_open, CHIP_ERROR_BUSY);
+
+		session_open = true;
+		next = Oldest();
+		last = newest;
+		offset = 0;
+
+		outHandle = kSessionHandle;
+		outTimeSinceBoot.SetValue(k_uptime_get() * USEC_PER_MSEC);
+
+		return CHIP_NO_ERROR;
+	}
+
+	CHIP_ERROR CollectLog(LogSessionHandle handle, MutableByteSpan &outBuffer, bool &outIsEndOfLog) override
+	{
+		VerifyOrReturnError(session_open && handle == kSessionHandle, CHIP_ERROR_INCORRECT_STATE);
+
+		Awake awake;
+		size_t written = 0;
+
+		while (next <= last && written < outBuffer.size()) {
+			// Overwritten by the ring since the transfer started
+			if (!BlockValid(next)) {
+				next++;
+				offset = 0;
+				continue;
+			}
+
+			size_t length = MIN(kBlockSize - offset, outBuffer.size() - written);
+
+			ReadBlock(next, offset, outBuffer.data() + written, length);
+			written += length;
+			offset += length;
+
+			if (offset == kBlockSize) {
+				next++;
+				offset = 0;
+			}
+		}
+
+		outBuffer.reduce_size(written);
+		outIsEndOfLog = next > last;
+
+		return CHIP_NO_ERROR;
+	}
+
+	CHIP_ERROR EndLogCollection(LogSessionHandle handle, CHIP_ERROR error) override
+	{
+		VerifyOrReturnError(session_open && handle == kSessionHandle, CHIP_ERROR_INCORRECT_STATE);
+
+		if (error != CHIP_NO_ERROR) {
+			LOG_WRN("Sample log transfer failed: %" CHIP_ERROR_FORMAT, error.Format());
+		}
+		session_open = false;
+
+		return CHIP_NO_ERROR;
+	}
+
+	size_t GetSizeForIntent(IntentEnum intent) override
+	{
+		size_t size = 0;
+
+		if (intent != IntentEnum::kEndUserSupport || !have_blocks) {
+			return 0;
+		}
+
+		Awake awake;
+
+		for (uint32_t sequence = Oldest(); sequence <= newest; sequence++) {
+			if (BlockValid(sequence)) {
+				size += kBlockSize;
+			}
+		}
+
+		return size;
+	}
+
+	// Without BDX only the newest blocks that fit the response are sent
+	CHIP_ERROR GetLogForIntent(IntentEnum intent, MutableByteSpan &outBuffer, Optional<uint64_t> &outTimeStamp,
+				   Optional<uint64_t> &outTimeSinceBoot) override
+	{
+		VerifyOrReturnError(intent == IntentEnum::kEndUserSupport && have_blocks, CHIP_ERROR_NOT_FOUND);
+
+		Awake awake;
+		uint32_t count = MIN(static_cast<uint32_t>(outBuffer.size() / kBlockSize), newest - Oldest() + 1);
+		size_t written = 0;
+
+		for (uint32_t sequence = newest + 1 - count; sequence <= newest; sequence++) {
+			if (BlockValid(sequence)) {
+				ReadBlock(sequence, 0, outBuffer.data() + written, kBlockSize);
+				written += kBlockSize;
+			}
+		}
+
+		outBuffer.reduce_size(written);
+		outTimeSinceBoot.SetValue(k_uptime_get() * USEC_PER_MSEC);
+
+		return CHIP_NO_ERROR;
+	}
+
+private:
+	bool session_open;
+	uint32_t next;
+	uint32_t last;
+	size_t offset;
+};
+
+Provider provider;
+
+} // namespace
+
+void emberAfDiagnosticLogsClusterInitCallback(EndpointId endpoint)
+{
+	DiagnosticLogsServer::Instance().SetDiagnosticLogsProviderDelegate(endpoint, &provider);
+}
+
+CHIP_ERROR SampleLog::Init()
+{
+	int ret = flash_area_open(PM_SAMPLE_LOG_ID, &area);
+
+	if (ret != 0) {
+		LOG_ERR("Failed to open sample log partition: %d", ret);
+		area = nullptr;
+		return CHIP_ERROR_INTERNAL;
+	}
+
+	explicit_erase = (flash_params_get_erase_cap(flash_get_parameters(area->fa_dev)) & FLASH_ERASE_C_EXPLICIT) != 0;
+
+	uint32_t reboot_count;
+
+	if (ConfigurationMgr().GetRebootCount(reboot_count) == CHIP_NO_ERROR) {
+		boot = static_cast<uint16_t>(reboot_count);
+	}
+
+	Awake awake;
+
+	for (uint32_t slot = 0; slot < kBlockCount; slot++) {
+		BlockHeader header;
+
+		if (Read(slot * kBlockSize, &header, sizeof(header)) && header.magic == kMagic &&
+		    header.sequence % kBlockCount == slot && (!have_blocks || header.sequence > newest)) {
+			newest = header.sequence;
+			have_blocks = true;
+		}
+	}
+
+	// The encoder state did not survive the reset, so the block the staged
+	// samples belong to is closed and the next sample starts a new one
+	if (tail->magic == kTailMagic && have_blocks && tail->sequence == newest && tail->offset < kBlockSize &&
+	    tail->used < kWordSize) {
+		FlushTail();
+	}
+	tail->magic = 0;
+
+	if (have_blocks) {
+		LOG_INF("Sample log holds blocks %u to %u", Oldest(), newest);
+	}
+
+	return CHIP_NO_ERROR;
+}
+
+void SampleLog::Append(int16_t temperature, uint16_t humidity)
+{
+	if (area == nullptr) {
+		return;
+	}
+
+	uint32_t start = k_cycle_get_32();
+	uint32_t start_words = words_written;
+
+	Store(Uptime(), temperature, humidity);
+
+	// Most appends only stage the record, the one that opens a block is the
+	// slowest, only new worst cases are logged
+	uint32_t append_us = k_cyc_to_us_ceil32(k_cycle_get_32() - start);
+
+	if (append_us > slowest_append_us) {
+		slowest_append_us = append_us;
+		LOG_INF("Slowest append so far: %u us, %u words written", append_us, words_written - start_words);
+	}
+}
+
+#endif // CONFIG_APP_SAMPLE_LOG
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include <stdint.h>
+
+// Store-and-forward log of every measurement, kept in the sample_log
+// partition so readings taken while the Thread parent is unreachable are not
+// lost. The partition is in RRAM on the internal layout and on the external
+// flash on the DK one. The backlog is retrieved in bulk through the
+// Diagnostic Logs cluster (EndUserSupport intent), over BDX when it does not
+// fit a response.
+//
+// The partition is a ring of 256 byte blocks. Each block starts with a 16 byte
+// header holding the absolute first sample, every following sample is a delta
+// record of usually two bytes, see sample_encoder.h. Records are staged in
+// retained RAM and written one whole RRAM word at a time, so a word
+// is written twice per pass over the ring, once cleared and once filled.
+// An append writes at most one word, except the one that opens a block: it
+// clears up to 16 words of the previous pass and writes the header, 17
+// writes, one more when it closes the previous block. On the external flash
+// the block that starts a 4 KB sector erases the sector instead of clearing
+// words. The slowest append so far is logged with its duration.
+// scripts/sample_log.py decodes a retrieved log.
+class SampleLog {
+public:
+#if CONFIG_APP_SAMPLE_LOG
+	// Finds the newest block and writes out what a reset left staged
+	CHIP_ERROR Init();
+
+	// Called with the Matter stack locked after every successful measurement
+	void Append(int16_t temperature, uint16_t humidity);
+#else
+	CHIP_ERROR Init() { return CHIP_NO_ERROR; }
+
+	void Append(int16_t temperature, uint16_t humidity) {}
+#endif // CONFIG_APP_SAMPLE_LOG
+};
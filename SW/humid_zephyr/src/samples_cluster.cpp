@@ -0,0 +1,110 @@
+#include "samples_cluster.h"
+#include "sample_encoder.h"
+
+#include <app/AttributeAccessInterfaceRegistry.h>
+#include <app/reporting/reporting.h>
+#include <lib/support/CodeUtils.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+
+#include <string.h>
+
+using namespace ::chip;
+using namespace ::chip::app;
+
+namespace {
+
+// Only used while encoding a read, too big for the Matter thread stack
+uint8_t packed[SamplesCluster::kMaxPackedSize];
+
+uint32_t Uptime()
+{
+	return static_cast<uint32_t>(k_uptime_get() / MSEC_PER_SEC);
+}
+
+} // namespace
+
+CHIP_ERROR SamplesCluster::Init()
+{
+	VerifyOrReturnError(AttributeAccessInterfaceRegistry::Instance().Register(this), CHIP_ERROR_INCORRECT_STATE);
+
+	return CHIP_NO_ERROR;
+}
+
+void SamplesCluster::Add(int16_t temperature, uint16_t humidity)
+{
+	uint32_t now = Uptime();
+
+	samples[next] = {
+		.uptime_s = now,
+		.temperature = temperature,
+		.humidity = humidity,
+	};
+	next = (next + 1) % ARRAY_SIZE(samples);
+	count = MIN(count + 1, ARRAY_SIZE(samples));
+	unreported++;
+
+	if (unreported < ARRAY_SIZE(samples) && now - batch_uptime_s < CONFIG_APP_SAMPLE_BATCH_INTERVAL_SEC) {
+		return;
+	}
+
+	MatterReportingAttributeChangeCallback(kEndpointId, HumidSamples::Id, HumidSamples::Attributes::Samples::Id);
+	batch_uptime_s = now;
+	unreported = 0;
+}
+
+const SamplesCluster::Sample &SamplesCluster::At(size_t i) const
+{
+	return samples[(next + ARRAY_SIZE(samples) - 1 - i) % ARRAY_SIZE(samples)];
+}
+
+size_t SamplesCluster::Pack(uint8_t *out, size_t size) const
+{
+	if (count == 0) {
+		return 0;
+	}
+
+	uint32_t now = Uptime();
+	const Sample &newest = At(0);
+	size_t length = SampleEncoder::PutVarint(out, now - newest.uptime_s);
+	SampleEncoder encoder;
+
+	sys_put_le16(newest.temperature, out + length);
+	sys_put_le16(newest.humidity, out + length + 2);
+	length += 4;
+
+	// Ages grow into the past, so they encode like times of a forward series
+	encoder.Start(now - newest.uptime_s, newest.temperature, newest.humidity);
+
+	for (size_t i = 1; i < count; i++) {
+		const Sample &sample = At(i);
+		uint8_t record[SampleEncoder::kMaxRecordSize];
+		size_t record_length = encoder.Encode(now - sample.uptime_s, sample.temperature, sample.humidity, record);
+
+		if (length + record_length > size) {
+			break;
+		}
+
+		memcpy(out + length, record, record_length);
+		length += record_length;
+		encoder.Commit();
+	}
+
+	return length;
+}
+
+CHIP_ERROR SamplesCluster::Read(const ConcreteReadAttributePath &path, AttributeValueEncoder &encoder)
+{
+	switch (path.mAttributeId) {
+	case HumidSamples::Attributes::Samples::Id:
+		return encoder.Encode(ByteSpan(packed, Pack(packed, sizeof(packed))));
+	default:
+		// BatchInterval, FeatureMap and ClusterRevision come from const_attributes.cpp through ember
+		return CHIP_NO_ERROR;
+	}
+}
+
+// Called by ember on startup, the attribute access interface is registered from SamplesCluster::Init
+void MatterHumidSamplesPluginServerInitCallback() {}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <app/AttributeAccessInterface.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+
+#include <stdint.h>
+
+// Vendor specific cluster on the sensor endpoint, see humid-clusters.xml
+namespace HumidSamples {
+
+inline constexpr chip::ClusterId Id = 0xFFF1FC01;
+
+namespace Attributes {
+namespace Samples {
+// Last CONFIG_APP_SAMPLE_BATCH_SIZE samples, newest first, packed as described at SamplesCluster
+inline constexpr chip::AttributeId Id = 0x0000;
+} // namespace Samples
+namespace BatchInterval {
+// Seconds between reports of Samples
+inline constexpr chip::AttributeId Id = 0x0001;
+} // namespace BatchInterval
+} // namespace Attributes
+
+} // namespace HumidSamples
+
+// Serves the HumidSamples attributes. Every measurement lands in a RAM ring,
+// but Samples is only marked changed once per CONFIG_APP_SAMPLE_BATCH_INTERVAL_SEC,
+// or earlier when the ring is about to overwrite unreported samples. A
+// subscriber thus gets an hour of minute samples in one report instead of
+// one report per change, while Temperature and Relative Humidity Measurement
+// keep carrying the latest value for standard controllers.
+//
+// Samples is an octet string, so its timestamps are relative to the moment it
+// is read:
+//   varint(age of the newest sample in s) int16 T, uint16 H (little endian)
+// followed by one sample_encoder.h record per older sample, with dt counting
+// further into the past. The oldest samples are left out when the result
+// would not fit kMaxPackedSize. scripts/sample_batch.py decodes it.
+class SamplesCluster : public chip::app::AttributeAccessInterface {
+public:
+	static constexpr chip::EndpointId kEndpointId = 1;
+
+	// An octet string cannot be chunked, it has to fit one report
+	static constexpr size_t kMaxPackedSize = 512;
+
+	SamplesCluster() : AttributeAccessInterface(chip::MakeOptional(kEndpointId), HumidSamples::Id) {}
+
+	CHIP_ERROR Init();
+
+	// Called with the Matter stack locked after every successful measurement
+	void Add(int16_t temperature, uint16_t humidity);
+
+	CHIP_ERROR Read(const chip::app::ConcreteReadAttributePath &path,
+			chip::app::AttributeValueEncoder &encoder) override;
+
+private:
+	struct Sample {
+		uint32_t uptime_s;
+		int16_t temperature;
+		uint16_t humidity;
+	};
+
+	// i-th newest sample
+	const Sample &At(size_t i) const;
+	size_t Pack(uint8_t *out, size_t size) const;
+
+	Sample samples[CONFIG_APP_SAMPLE_BATCH_SIZE];
+	size_t count = 0;
+	size_t next = 0;
+	size_t unreported = 0;
+	uint32_t batch_uptime_s = 0;
+};
@@ -0,0 +1,362 @@
+#include "sensor_bench.h"
+
+#if CONFIG_APP_SENSOR_BENCH
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/util.h>
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+using HeaterPower = Sht4x::HeaterPower;
+using Repeatability = Sht4x::Repeatability;
+
+// Power of two latency buckets, the last one collects everything above ~1 s
+constexpr size_t kBuckets = 21;
+constexpr size_t kBarWidth = 40;
+
+// Heater duty cycle must stay below 5 %, datasheet section 4.9
+constexpr uint32_t kHeaterDutyPercent = 5;
+
+// Reads block for up to a heater pulse, they get their own thread
+constexpr size_t kStackSize = 2048;
+
+const char *const kRepeatabilityNames[] = {"low", "medium", "high"};
+const char *const kHeaterPowerNames[] = {"200mw", "110mw", "20mw"};
+
+static_assert(ARRAY_SIZE(kRepeatabilityNames) == static_cast<size_t>(Repeatability::kCount));
+static_assert(ARRAY_SIZE(kHeaterPowerNames) == static_cast<size_t>(HeaterPower::kCount));
+
+#if CONFIG_SHT4X_USE_HEATER
+constexpr HeaterPower kDefaultHeaterPower = static_cast<HeaterPower>(CONFIG_SHT4X_HEATER_PULSE_POWER);
+#else
+constexpr HeaterPower kDefaultHeaterPower = HeaterPower::k20mW;
+#endif
+
+struct Result {
+	uint32_t latency_us[CONFIG_APP_SENSOR_BENCH_MAX_ITERATIONS];
+	uint32_t histogram[kBuckets];
+	uint32_t count;
+	uint32_t failures;
+	uint64_t total_us;
+	uint64_t busy_us;
+};
+
+// What the shell asked for, and how far the bench got
+struct Run {
+	const struct shell *shell;
+	size_t repeatability;
+	size_t last;
+	uint32_t iterations;
+	bool allow_heater;
+	// Forced pulse after every read
+	bool pulse;
+	HeaterPower power;
+	bool long_pulse;
+	// At the start of the current repeatability
+	Sht4x::BusErrors errors;
+	uint32_t heater_pulses;
+	// Uptime the heater duty cycle allows the next read at, across runs
+	int64_t next_ms;
+	atomic_t running;
+	atomic_t stop;
+};
+
+Sht4x *sht4x;
+
+// Too big for the shell stack
+Result result;
+Run run;
+
+K_THREAD_STACK_DEFINE(bench_stack, kStackSize);
+struct k_work_q bench_queue;
+
+void ReadHandler(struct k_work *work);
+void PaceExpired(struct k_timer *timer);
+
+K_WORK_DEFINE(read_work, ReadHandler);
+// Starts the next read once the heater duty cycle allows it
+K_TIMER_DEFINE(pace_timer, PaceExpired, nullptr);
+
+size_t Bucket(uint32_t us)
+{
+	return us == 0 ? 0 : MIN(static_cast<size_t>(31 - __builtin_clz(us)), kBuckets - 1);
+}
+
+// Cycles the calling thread has been running, the rest of a read is
+// spent blocked on the bus or sleeping through the conversion
+uint64_t BusyCycles()
+{
+#if CONFIG_THREAD_RUNTIME_STATS
+	k_thread_runtime_stats_t stats;
+
+	if (k_thread_runtime_stats_get(k_current_get(), &stats) == 0) {
+		return stats.execution_cycles;
+	}
+#endif
+	return 0;
+}
+
+void Print(const struct shell *shell, Repeatability repeatability, const Sht4x::BusErrors &errors,
+	   uint32_t heater_pulses)
+{
+	uint32_t *latency = result.latency_us;
+	uint32_t count = result.count;
+
+	std::sort(latency, latency + count);
+
+	shell_print(shell, "%s, heater %s: %u reads, %u failed, %u I2C errors, %u CRC errors, %u heater pulses",
+		    kRepeatabilityNames[static_cast<size_t>(repeatability)],
+		    run.pulse ? kHeaterPowerNames[static_cast<size_t>(run.power)] : run.allow_heater ? "on" : "off",
+		    count, result.failures, errors.i2c, errors.crc, heater_pulses);
+	shell_print(shell, "  latency us: min %u avg %u p99 %u max %u", latency[0],
+		    static_cast<uint32_t>(result.total_us / count), latency[(count * 99 + 99) / 100 - 1],
+		    latency[count - 1]);
+
+	if (IS_ENABLED(CONFIG_THREAD_RUNTIME_STATS)) {
+		uint32_t busy_us = result.busy_us / count;
+		uint32_t wait_us = (result.total_us - MIN(result.busy_us, result.total_us)) / count;
+
+		shell_print(shell, "  per read: cpu busy %u us, idle wait %u us (%u%% busy)", busy_us, wait_us,
+			    static_cast<uint32_t>(result.busy_us * 100 / MAX(result.total_us, 1)));
+	} else {
+		shell_print(shell, "  per read: cpu busy n/a, needs CONFIG_THREAD_RUNTIME_STATS");
+	}
+
+	uint32_t peak = *std::max_element(result.histogram, result.histogram + kBuckets);
+
+	for (size_t i = 0; i < kBuckets; i++) {
+		char bar[kBarWidth + 1];
+		size_t width;
+
+		if (result.histogram[i] == 0) {
+			continue;
+		}
+
+		width = MAX(result.histogram[i] * kBarWidth / peak, 1);
+		memset(bar, '#', width);
+		bar[width] = '\0';
+		shell_print(shell, "  %7u - %7u us %5u %s", 1u << i, (2u << i) - 1, result.histogram[i], bar);
+	}
+}
+
+void StartRepeatability()
+{
+	memset(&result, 0, sizeof(result));
+	run.errors = sht4x->Errors();
+	run.heater_pulses = sht4x->EnergyToday().heater_pulses;
+}
+
+// Prints the repeatability that just finished, false once all are done
+bool FinishRepeatability()
+{
+	Sht4x::BusErrors errors = sht4x->Errors();
+	uint32_t heater_pulses = sht4x->EnergyToday().heater_pulses;
+
+	// Day rollover resets the counter, a pulse more or less doesn't matter here
+	heater_pulses -= MIN(run.heater_pulses, heater_pulses);
+
+	errors.i2c -= run.errors.i2c;
+	errors.crc -= run.errors.crc;
+
+	if (result.count > 0) {
+		Print(run.shell, static_cast<Repeatability>(run.repeatability), errors, heater_pulses);
+	}
+
+	if (atomic_get(&run.stop) || run.repeatability == run.last) {
+		return false;
+	}
+
+	run.repeatability++;
+	StartRepeatability();
+
+	return true;
+}
+
+void PaceExpired(struct k_timer *timer)
+{
+	k_work_submit_to_queue(&bench_queue, &read_work);
+}
+
+// One read, and the forced pulse after it. Readings keep counting towards
+// the sensor energy statistics, the measurement work waits for the bus in
+// between.
+void ReadHandler(struct k_work *work)
+{
+	auto repeatability = static_cast<Repeatability>(run.repeatability);
+	uint32_t heater_pulses = sht4x->EnergyToday().heater_pulses;
+	int64_t started_ms = k_uptime_get();
+	int16_t temperature;
+	uint16_t humidity;
+
+	uint64_t busy_start = BusyCycles();
+	uint32_t start = k_cycle_get_32();
+	bool success = sht4x->Read(temperature, humidity, repeatability, run.allow_heater);
+	uint32_t latency_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	result.latency_us[result.count++] = latency_us;
+	result.histogram[Bucket(latency_us)]++;
+	result.total_us += latency_us;
+	result.busy_us += k_cyc_to_us_floor64(BusyCycles() - busy_start);
+	if (!success) {
+		result.failures++;
+	}
+
+	uint32_t heater_ms = 0;
+
+	if (sht4x->EnergyToday().heater_pulses != heater_pulses) {
+		heater_ms += Sht4x::HeaterPulseMs(IS_ENABLED(CONFIG_SHT4X_HEATER_LONG_PULSE_DURATION));
+	}
+
+	if (run.pulse && sht4x->Heat(temperature, humidity, run.power, run.long_pulse)) {
+		heater_ms += Sht4x::HeaterPulseMs(run.long_pulse);
+	}
+
+	// The heater may be on for a twentieth of the time from one pulse to the next
+	run.next_ms = started_ms + int64_t(heater_ms) * 100 / kHeaterDutyPercent;
+
+	if (result.count == run.iterations || atomic_get(&run.stop)) {
+		if (!FinishRepeatability()) {
+			shell_print(run.shell, "sensor bench %s", atomic_get(&run.stop) ? "stopped" : "done");
+			atomic_clear(&run.stop);
+			atomic_clear(&run.running);
+			return;
+		}
+	}
+
+	k_timer_start(&pace_timer, K_MSEC(MAX(run.next_ms - k_uptime_get(), 0)), K_NO_WAIT);
+}
+
+bool ParseArgument(const char *arg, size_t &first, size_t &last)
+{
+	if (strcmp(arg, "heater") == 0) {
+		run.allow_heater = true;
+		return true;
+	}
+
+	if (strcmp(arg, "pulse") == 0) {
+		run.pulse = true;
+		return true;
+	}
+
+	if (strcmp(arg, "long") == 0 || strcmp(arg, "short") == 0) {
+		run.pulse = true;
+		run.long_pulse = arg[0] == 'l';
+		return true;
+	}
+
+	if (strcmp(arg, "all") == 0) {
+		return true;
+	}
+
+	for (size_t p = 0; p < ARRAY_SIZE(kHeaterPowerNames); p++) {
+		if (strcmp(arg, kHeaterPowerNames[p]) == 0) {
+			run.pulse = true;
+			run.power = static_cast<HeaterPower>(p);
+			return true;
+		}
+	}
+
+	for (size_t r = 0; r < ARRAY_SIZE(kRepeatabilityNames); r++) {
+		if (strcmp(arg, kRepeatabilityNames[r]) == 0) {
+			first = last = r;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static int BenchCommand(const struct shell *shell, size_t argc, char **argv)
+{
+	size_t first = 0;
+	size_t last = static_cast<size_t>(Repeatability::kCount) - 1;
+
+	if (argc == 2 && strcmp(argv[1], "stop") == 0) {
+		if (atomic_get(&run.running)) {
+			atomic_set(&run.stop, 1);
+		}
+		return 0;
+	}
+
+	if (sht4x == nullptr || !sht4x->Ready()) {
+		shell_error(shell, "SHT4x not ready");
+		return -ENODEV;
+	}
+
+	if (atomic_get(&run.running)) {
+		shell_error(shell, "sensor bench is running, stop it with: sensor bench stop");
+		return -EBUSY;
+	}
+
+	run.iterations = 50;
+	run.allow_heater = false;
+	run.pulse = false;
+	run.power = kDefaultHeaterPower;
+	run.long_pulse = IS_ENABLED(CONFIG_SHT4X_HEATER_LONG_PULSE_DURATION);
+
+	for (size_t i = 1; i < argc; i++) {
+		if (argv[i][0] >= '0' && argv[i][0] <= '9') {
+			run.iterations = atoi(argv[i]);
+			if (run.iterations == 0 || run.iterations > CONFIG_APP_SENSOR_BENCH_MAX_ITERATIONS) {
+				shell_error(shell, "Invalid iterations. Use 1-%u.", CONFIG_APP_SENSOR_BENCH_MAX_ITERATIONS);
+				return -EINVAL;
+			}
+		} else if (!ParseArgument(argv[i], first, last)) {
+			shell_error(shell, "Unknown argument: %s", argv[i]);
+			return -EINVAL;
+		}
+	}
+
+	run.shell = shell;
+	run.repeatability = first;
+	run.last = last;
+	atomic_set(&run.running, 1);
+	StartRepeatability();
+
+	if (run.pulse) {
+		shell_print(shell, "Pulsing the heater at %s for %u ms after every read, paced to a %u%% duty cycle",
+			    kHeaterPowerNames[static_cast<size_t>(run.power)], Sht4x::HeaterPulseMs(run.long_pulse),
+			    kHeaterDutyPercent);
+	}
+
+	k_timer_start(&pace_timer, K_MSEC(MAX(run.next_ms - k_uptime_get(), 0)), K_NO_WAIT);
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+	sensor_cmds,
+	SHELL_CMD_ARG(bench, NULL,
+		"Time SHT4x reads in the background\n"
+		"Usage: sensor bench [iterations] [low|medium|high|all] [heater]\n"
+		"                    [pulse] [200mw|110mw|20mw] [long|short]\n"
+		"       sensor bench stop\n"
+		"  iterations: reads per repeatability (default: 50)\n"
+		"  heater: let reads pulse the heater as the measurement path does\n"
+		"  pulse: pulse the heater after every read, at the given power\n"
+		"         and duration (default: the SHT4X_HEATER_* settings)\n"
+		"  Heater pulses are paced to a 5% duty cycle",
+		BenchCommand, 1, 6),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(sensor, &sensor_cmds, "Sensor commands", NULL);
+
+} // namespace
+
+void SensorBenchInit(Sht4x &sensor)
+{
+	sht4x = &sensor;
+
+	struct k_work_queue_config config = {.name = "sensor_bench"};
+
+	k_work_queue_start(&bench_queue, bench_stack, K_THREAD_STACK_SIZEOF(bench_stack),
+			   K_LOWEST_APPLICATION_THREAD_PRIO, &config);
+}
+
+#endif // CONFIG_APP_SENSOR_BENCH
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "sht4x.h"
+
+#if CONFIG_APP_SENSOR_BENCH
+
+// Registers the sensor to benchmark with the `sensor bench` shell command
+void SensorBenchInit(Sht4x &sensor);
+
+#else
+
+inline void SensorBenchInit(Sht4x &sensor) {}
+
+#endif // CONFIG_APP_SENSOR_BENCH
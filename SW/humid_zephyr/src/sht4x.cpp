@@ -1,8 +1,14 @@
 #include "sht4x.h"
+#include "trace.h"
 
 #include <zephyr/drivers/sensor/sht4x.h>
 #include <zephyr/drivers/sensor.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/util.h>
+
+#include <stdlib.h>
 
 LOG_MODULE_REGISTER(sht4x, CONFIG_CHIP_APP_LOG_LEVEL);
 
@@ -10,13 +16,70 @@ LOG_MODULE_REGISTER(sht4x, CONFIG_CHIP_APP_LOG_LEVEL);
 #error "No sensirion,sht4x compatible node found in the device tree"
 #endif
 
+#define SHT4X_NODE DT_COMPAT_GET_ANY_STATUS_OKAY(sensirion_sht4x)
+
+#define SHT4X_CRC_POLY 0x31
+#define SHT4X_CRC_INIT 0xFF
+
+namespace {
+
+constexpr int64_t kDayMs = 24 * 60 * 60 * 1000LL;
+
+struct Conversion {
+	uint8_t command;
+	// Maximum conversion time
+	uint16_t wait_us;
+	// Typical energy per conversion, 320 uA during the typical conversion time at 3.3 V
+	uint16_t energy_nj;
+	int16_t temperature_noise;
+	uint16_t humidity_noise;
+};
+
+// Indexed by Sht4x::Repeatability, datasheet tables 1, 2 and 7
+constexpr Conversion kConversions[] = {
+	{0xE0, 1600, 1373, 10, 25},
+	{0xF6, 4500, 3907, 7, 15},
+	{0xFD, 8300, 7286, 4, 8},
+};
+
+struct HeaterPulse {
+	uint8_t long_command;
+	uint8_t short_command;
+	// From the Kconfig help, at 3.3 V
+	uint32_t power_mw;
+};
+
+// Indexed by Sht4x::HeaterPower, datasheet table 8
+constexpr HeaterPulse kHeaterPulses[] = {
+	{0x39, 0x32, 200},
+	{0x2F, 0x24, 110},
+	{0x1E, 0x15, 20},
+};
+
+static_assert(ARRAY_SIZE(kHeaterPulses) == static_cast<size_t>(Sht4x::HeaterPower::kCount));
+
+#if CONFIG_SHT4X_USE_HEATER
+constexpr uint64_t kHeaterEnergyNj = kHeaterPulses[CONFIG_SHT4X_HEATER_PULSE_POWER].power_mw *
+				     Sht4x::HeaterPulseMs(IS_ENABLED(CONFIG_SHT4X_HEATER_LONG_PULSE_DURATION)) * 1000;
+#endif
+
+const Conversion &ConversionFor(Sht4x::Repeatability repeatability)
+{
+	return kConversions[static_cast<size_t>(repeatability)];
+}
+
+} // namespace
+
 CHIP_ERROR Sht4x::Init()
 {
 	CHIP_ERROR err = CHIP_NO_ERROR;
 
 	LOG_DBG("Initialize sensirion_sht4x");
-	
-	sht = DEVICE_DT_GET_ANY(sensirion_sht4x);
+
+	sht = DEVICE_DT_GET(SHT4X_NODE);
+	i2c = I2C_DT_SPEC_GET(SHT4X_NODE);
+	k_mutex_init(&lock);
+	day_start_ms = k_uptime_get();
 
     if (!device_is_ready(sht))
     {
@@ -25,12 +88,12 @@ CHIP_ERROR Sht4x::Init()
     }
 
 
-#if APP_SHT4X_USE_HEATER
+#if CONFIG_SHT4X_USE_HEATER
 	struct sensor_value heater_p;
 	struct sensor_value heater_d;
 
 	heater_p.val1 = CONFIG_SHT4X_HEATER_PULSE_POWER;
-	heater_d.val1 = !!CONFIG_SHT4X_HEATER_PULSE_DURATION_LONG;
+	heater_d.val1 = IS_ENABLED(CONFIG_SHT4X_HEATER_LONG_PULSE_DURATION);
 	sensor_attr_set(sht, SENSOR_CHAN_ALL, SENSOR_ATTR_SHT4X_HEATER_POWER, &heater_p);
 	sensor_attr_set(sht, SENSOR_CHAN_ALL, SENSOR_ATTR_SHT4X_HEATER_DURATION, &heater_d);
 #endif
@@ -43,26 +106,126 @@ bool Sht4x::Ready()
 	return device_is_ready(sht);
 }
 
-bool Sht4x::Read(int16_t &temperature, uint16_t &humidity)
+int16_t Sht4x::TemperatureNoise(Repeatability repeatability)
 {
-	struct sensor_value temp, hum;
-	int rc;
+	return ConversionFor(repeatability).temperature_noise;
+}
 
-	rc = sensor_sample_fetch(sht);
+uint16_t Sht4x::HumidityNoise(Repeatability repeatability)
+{
+	return ConversionFor(repeatability).humidity_noise;
+}
+
+int Sht4x::Measure(Repeatability repeatability, int16_t &temperature, uint16_t &humidity)
+{
+	const Conversion &conversion = ConversionFor(repeatability);
+	TraceScope trace(TracePhase::kSensorFetch);
+	uint8_t rx[6];
+
+	// The driver only supports the repeatability set in the devicetree,
+	// so single shot measurements are issued directly on the bus
+	int rc = Transfer(conversion.command, K_USEC(conversion.wait_us), rx);
 	if (rc != 0) {
-		LOG_ERR("Failed to fetch sample from SHT4X: %d", rc);
-		return false;
+		return rc;
 	}
 
-	rc = sensor_channel_get(sht, SENSOR_CHAN_AMBIENT_TEMP, &temp);
+	AccountConversion(repeatability);
+
+	return Decode(rx, temperature, humidity);
+}
+
+int Sht4x::Transfer(uint8_t command, k_timeout_t wait, uint8_t (&rx)[6])
+{
+	int rc = i2c_write_dt(&i2c, &command, sizeof(command));
 	if (rc != 0) {
-		LOG_ERR("Failed to read SHT4X temperature: %d", rc);
+		errors.i2c++;
+		return rc;
+	}
+
+	k_sleep(wait);
+
+	rc = i2c_read_dt(&i2c, rx, sizeof(rx));
+	if (rc != 0) {
+		errors.i2c++;
+		return rc;
+	}
+
+	return 0;
+}
+
+int Sht4x::Decode(const uint8_t (&rx)[6], int16_t &temperature, uint16_t &humidity)
+{
+	if (crc8(&rx[0], 2, SHT4X_CRC_POLY, SHT4X_CRC_INIT, false) != rx[2] ||
+	    crc8(&rx[3], 2, SHT4X_CRC_POLY, SHT4X_CRC_INIT, false) != rx[5]) {
+		errors.crc++;
+		return -EIO;
+	}
+
+	// Datasheet section 4.6, converted straight to Matter units
+	int32_t t_ticks = sys_get_be16(&rx[0]);
+	int32_t rh_ticks = sys_get_be16(&rx[3]);
+
+	temperature = -4500 + (17500 * t_ticks) / 65535;
+	humidity = CLAMP(-600 + (12500 * rh_ticks) / 65535, 0, 10000);
+
+	return 0;
+}
+
+bool Sht4x::Read(int16_t &temperature, uint16_t &humidity, Repeatability repeatability, bool allow_heater)
+{
+	// The shell bench reads outside the measurement work
+	k_mutex_lock(&lock, K_FOREVER);
+	bool success = ReadLocked(temperature, humidity, repeatability, allow_heater);
+	k_mutex_unlock(&lock);
+
+	return success;
+}
+
+bool Sht4x::Heat(int16_t &temperature, uint16_t &humidity, HeaterPower power, bool long_pulse)
+{
+	const HeaterPulse &pulse = kHeaterPulses[static_cast<size_t>(power)];
+	uint32_t pulse_ms = HeaterPulseMs(long_pulse);
+	uint8_t rx[6];
+	int rc;
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	rc = Measure(Repeatability::kHigh, temperature, humidity);
+	if (rc != 0 || temperature >= SHT4X_HEATER_MAX_TEMP_C * 100) {
+		k_mutex_unlock(&lock);
+		LOG_ERR("Heater pulse refused: %d", rc != 0 ? rc : -ERANGE);
 		return false;
 	}
 
-	rc = sensor_channel_get(sht, SENSOR_CHAN_HUMIDITY, &hum);
+	// The pulse ends with a high repeatability measurement, read it then
+	TraceBegin(TracePhase::kHeater);
+	rc = Transfer(long_pulse ? pulse.long_command : pulse.short_command, K_MSEC(pulse_ms), rx);
+	TraceEnd(TracePhase::kHeater);
+
+	if (rc == 0) {
+		RollOverDay();
+		today.heater_pulses++;
+		today.energy_nj += uint64_t(pulse.power_mw) * pulse_ms * 1000;
+		today.energy_all_high_nj += uint64_t(pulse.power_mw) * pulse_ms * 1000;
+		rc = Decode(rx, temperature, humidity);
+	}
+
+	k_mutex_unlock(&lock);
+
+	if (rc != 0) {
+		LOG_ERR("Failed to pulse SHT4X heater: %d", rc);
+	}
+
+	return rc == 0;
+}
+
+bool Sht4x::ReadLocked(int16_t &temperature, uint16_t &humidity, Repeatability repeatability, bool allow_heater)
+{
+	int rc;
+
+	rc = Measure(repeatability, temperature, humidity);
 	if (rc != 0) {
-		LOG_ERR("Failed to read SHT4X humidity: %d", rc);
+		LOG_ERR("Failed to fetch sample from SHT4X: %d", rc);
 		return false;
 	}
 
@@ -76,29 +239,78 @@ bool Sht4x::Read(int16_t &temperature, uint16_t &humidity)
 		 *
 		 * The temperature data will not be updated here for obvious reasons.
 		 **/
-		if (hum.val1 > CONFIG_SHT4X_HEATER_HUMIDITY_THRESH &&
-		    temp.val1 < SHT4X_HEATER_MAX_TEMP_C) {
+		// A heater pulse costs far more than a precise reading, so don't let
+		// low repeatability noise decide whether to use it
+		if (allow_heater && repeatability != Repeatability::kHigh &&
+		    abs(humidity - CONFIG_SHT4X_HEATER_HUMIDITY_THRESH * 100) <= HumidityNoise(repeatability)) {
+			repeatability = Repeatability::kHigh;
+			rc = Measure(repeatability, temperature, humidity);
+			if (rc != 0) {
+				LOG_ERR("Failed to fetch sample from SHT4X: %d", rc);
+				return false;
+			}
+		}
+
+		if (allow_heater && humidity > CONFIG_SHT4X_HEATER_HUMIDITY_THRESH * 100 &&
+		    temperature < SHT4X_HEATER_MAX_TEMP_C * 100) {
+			struct sensor_value hum;
+
 			LOG_INF("Activating heater");
 
-			if (sht4x_fetch_with_heater(sht)) {
+			TraceBegin(TracePhase::kHeater);
+			rc = sht4x_fetch_with_heater(sht);
+			TraceEnd(TracePhase::kHeater);
+			if (rc != 0) {
+				errors.i2c++;
 				LOG_ERR("Failed to fetch sample from SHT4X device");
 				return false;
 			}
 
+			RollOverDay();
+			today.heater_pulses++;
+			today.energy_nj += kHeaterEnergyNj;
+			today.energy_all_high_nj += kHeaterEnergyNj;
+
 			sensor_channel_get(sht, SENSOR_CHAN_HUMIDITY, &hum);
+			humidity = (hum.val1 * 100) + (hum.val2 / 10000);
 		}
 #endif
 
-	// Convert to Matter format
-	// Temperature: 0.01°C units
-	temperature = (temp.val1 * 100) + (temp.val2 / 10000);
+	// The sign on its own, -0.50 has no negative integer part to carry it
+	LOG_INF("SHT4X: %s%d.%02d°C, %d.%02d%% RH (Matter: temp=%d, hum=%d, repeatability=%d)",
+		temperature < 0 ? "-" : "", abs(temperature) / 100, abs(temperature) % 100,
+		humidity / 100, humidity % 100, temperature, humidity, static_cast<int>(repeatability));
 
-	// Humidity: 0.01% units (0-10000 = 0-100%)
-	humidity = (hum.val1 * 100) + (hum.val2 / 10000);
+	return true;
+}
 
-	LOG_INF("SHT4X: %d.%02d°C, %d.%02d%% RH (Matter: temp=%d, hum=%d)",
-		temp.val1, temp.val2 / 10000, hum.val1, hum.val2 / 10000,
-		temperature, humidity);
+void Sht4x::AccountConversion(Repeatability repeatability)
+{
+	RollOverDay();
 
-	return true;
+	today.conversions[static_cast<size_t>(repeatability)]++;
+	today.energy_nj += ConversionFor(repeatability).energy_nj;
+	today.energy_all_high_nj += ConversionFor(Repeatability::kHigh).energy_nj;
+}
+
+void Sht4x::RollOverDay()
+{
+	int64_t days = (k_uptime_get() - day_start_ms) / kDayMs;
+
+	if (days == 0) {
+		return;
+	}
+
+	// Rolled over on every conversion, so everything in today happened on
+	// its first day. After a gap of more than a day the last full one was idle.
+	last_day = days == 1 ? today : EnergyStats{};
+	today = {};
+	day_start_ms += days * kDayMs;
+
+	LOG_INF("Sensor energy last day: %u uJ (%u uJ if always high repeatability), "
+		"%u/%u/%u low/medium/high conversions, %u heater pulses",
+		static_cast<uint32_t>(last_day.energy_nj / 1000),
+		static_cast<uint32_t>(last_day.energy_all_high_nj / 1000),
+		last_day.conversions[0], last_day.conversions[1], last_day.conversions[2],
+		last_day.heater_pulses);
 }
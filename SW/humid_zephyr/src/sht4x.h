@@ -2,6 +2,9 @@
 
 #include <lib/core/CHIPError.h>
 
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/kernel.h>
+
 using namespace chip;
 
 // Above this temperature the heater should not be used
@@ -9,6 +12,38 @@ using namespace chip;
 
 class Sht4x {
 public:
+	// Measurement repeatability, higher takes longer and uses more energy
+	// but has less noise (datasheet table 1, 3 sigma repeatability)
+	enum class Repeatability : uint8_t {
+		kLow,    // 1.3 ms, 0.10 °C, 0.25 %RH
+		kMedium, // 3.7 ms, 0.07 °C, 0.15 %RH
+		kHigh,   // 6.9 ms, 0.04 °C, 0.08 %RH
+		kCount,
+	};
+
+	// Heater power settings, the index CONFIG_SHT4X_HEATER_PULSE_POWER uses
+	enum class HeaterPower : uint8_t {
+		k200mW,
+		k110mW,
+		k20mW,
+		kCount,
+	};
+
+	// Sensor energy use, accumulated over the last full day and the current one
+	struct EnergyStats {
+		uint32_t conversions[static_cast<size_t>(Repeatability::kCount)];
+		uint32_t heater_pulses;
+		uint64_t energy_nj;
+		// Energy that would have been used by only doing high repeatability conversions
+		uint64_t energy_all_high_nj;
+	};
+
+	// Failed transfers and CRC mismatches since boot
+	struct BusErrors {
+		uint32_t i2c;
+		uint32_t crc;
+	};
+
 	CHIP_ERROR Init();
 
 	bool Ready();
@@ -17,9 +52,44 @@ public:
 	// Returns true on success, false on error
 	// temperature: in 0.01°C units (Matter format)
 	// humidity: in 0.01% units (0-10000 = 0-100%)
-	// Will activate heater as necessary
-	bool Read(int16_t &temperature, uint16_t &humidity);
+	// Will activate heater as necessary, unless allow_heater is false
+	// Safe to call from several threads, reads are serialized
+	bool Read(int16_t &temperature, uint16_t &humidity, Repeatability repeatability = Repeatability::kHigh,
+		  bool allow_heater = true);
+
+	// Forces a heater pulse of 1.1 s, or 0.11 s when not long, and returns the
+	// high repeatability reading taken at its end. Refused, returning false,
+	// above SHT4X_HEATER_MAX_TEMP_C. Counts towards the heater statistics.
+	// Keeping the heater within its duty cycle is up to the caller.
+	bool Heat(int16_t &temperature, uint16_t &humidity, HeaterPower power, bool long_pulse);
+
+	static constexpr uint32_t HeaterPulseMs(bool long_pulse) { return long_pulse ? 1100 : 110; }
+
+	// Worst case noise of a reading at the given repeatability, in 0.01 units
+	static int16_t TemperatureNoise(Repeatability repeatability);
+	static uint16_t HumidityNoise(Repeatability repeatability);
+
+	const EnergyStats &EnergyLastDay() const { return last_day; }
+	const EnergyStats &EnergyToday() const { return today; }
+	const BusErrors &Errors() const { return errors; }
+
+	// Heater duty history survives brown-outs through the checkpoint
+	void RestoreHeaterPulses(uint32_t heater_pulses) { today.heater_pulses = heater_pulses; }
 
 private:
+	bool ReadLocked(int16_t &temperature, uint16_t &humidity, Repeatability repeatability, bool allow_heater);
+	int Measure(Repeatability repeatability, int16_t &temperature, uint16_t &humidity);
+	int Transfer(uint8_t command, k_timeout_t wait, uint8_t (&rx)[6]);
+	int Decode(const uint8_t (&rx)[6], int16_t &temperature, uint16_t &humidity);
+	void AccountConversion(Repeatability repeatability);
+	void RollOverDay();
+
 	const struct device *sht;
+	struct i2c_dt_spec i2c;
+	struct k_mutex lock;
+
+	int64_t day_start_ms = 0;
+	EnergyStats today = {};
+	EnergyStats last_day = {};
+	BusErrors errors = {};
 };
@@ -0,0 +1,211 @@
+// AppTask for native_sim: the measurement and report step of app_task.cpp
+// (MeasurePipeline) against the emulated SHT4x, with a loopback attribute
+// sink in place of the Matter data model and transport. Each measurement is timed and the run ends with
+// a summary, so regressions in latency, allocation and workqueue stall
+// behavior show up in CI.
+
+#include "app_task.h"
+#include "adaptive_interval.h"
+#include "measure_pipeline.h"
+#include "sht4x.h"
+
+#include <lib/support/CodeUtils.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/mem_stats.h>
+#include <zephyr/sys/util.h>
+
+#include <posix_board_if.h>
+
+extern "C" int malloc_runtime_stats_get(struct sys_memory_stats *stats);
+
+LOG_MODULE_REGISTER(app_task, CONFIG_CHIP_APP_LOG_LEVEL);
+
+namespace {
+
+// Stands in for the measurement cluster attributes. A changed value is
+// marked dirty and delivered by the loopback subscriber, which runs after
+// the measurement like the Matter report engine does.
+struct LoopbackAttributes : public AttributeSink {
+	void SetTemperature(int16_t value) override
+	{
+		temperature = value;
+		valid = true;
+		dirty = true;
+		sets++;
+	}
+
+	void SetHumidity(uint16_t value) override
+	{
+		humidity = value;
+		valid = true;
+		dirty = true;
+		sets++;
+	}
+
+	void SetNull() override
+	{
+		valid = false;
+		dirty = true;
+		sets += 2;
+	}
+
+	int16_t temperature;
+	uint16_t humidity;
+	bool valid;
+	bool dirty;
+	uint32_t sets;
+	uint32_t reports;
+};
+
+struct BenchStats {
+	uint32_t runs;
+	uint32_t failures;
+	uint64_t latency_total_us;
+	uint32_t latency_max_us;
+	uint32_t stall_max_us;
+	size_t allocated_max;
+};
+
+Sht4x sht4x;
+MeasurePipeline measure_pipeline(sht4x);
+AdaptiveInterval interval;
+LoopbackAttributes attributes;
+BenchStats stats;
+
+k_work_handler_t measure_handler;
+struct k_work_delayable measure_work;
+struct k_work report_work;
+struct k_work stall_probe;
+struct k_work finish_work;
+uint32_t stall_probe_cycles;
+
+size_t HeapAllocated()
+{
+	struct sys_memory_stats heap;
+
+	return malloc_runtime_stats_get(&heap) == 0 ? heap.allocated_bytes : 0;
+}
+
+uint32_t CyclesToUs(uint32_t cycles)
+{
+	return k_cyc_to_us_floor32(cycles);
+}
+
+void ReportWork(struct k_work *work)
+{
+	if (!attributes.dirty) {
+		return;
+	}
+
+	attributes.dirty = false;
+	attributes.reports++;
+
+	if (attributes.valid) {
+		LOG_DBG("Report: temp=%d hum=%u", attributes.temperature, attributes.humidity);
+	} else {
+		LOG_DBG("Report: null");
+	}
+}
+
+// Submitted as the measurement starts, so it runs as soon as the
+// workqueue is free again: its delay is how long other work was stalled
+void StallProbe(struct k_work *work)
+{
+	stats.stall_max_us = MAX(stats.stall_max_us, CyclesToUs(k_cycle_get_32() - stall_probe_cycles));
+}
+
+void PrintStats()
+{
+	LOG_INF("bench: runs=%u failures=%u latency_avg_us=%u latency_max_us=%u stall_max_us=%u "
+		"alloc_max_bytes=%u sets=%u reports=%u",
+		stats.runs, stats.failures,
+		stats.runs ? static_cast<uint32_t>(stats.latency_total_us / stats.runs) : 0,
+		stats.latency_max_us, stats.stall_max_us, static_cast<uint32_t>(stats.allocated_max),
+		attributes.sets, attributes.reports);
+}
+
+// Queued behind the last report, so everything the measurement triggered is counted
+void FinishWork(struct k_work *work)
+{
+	PrintStats();
+	// Failures only fail the run when they were not injected
+	posix_exit(stats.failures && CONFIG_APP_SIM_SHT4X_FAIL_EVERY == 0 ? 1 : 0);
+}
+
+void BenchWork(struct k_work *work)
+{
+	size_t allocated = HeapAllocated();
+
+	stall_probe_cycles = k_cycle_get_32();
+	k_work_submit(&stall_probe);
+
+	uint32_t start = k_cycle_get_32();
+	measure_handler(work);
+	uint32_t latency_us = CyclesToUs(k_cycle_get_32() - start);
+
+	stats.runs++;
+	stats.latency_total_us += latency_us;
+	stats.latency_max_us = MAX(stats.latency_max_us, latency_us);
+	// The measurement path should not allocate at all
+	size_t allocated_after = HeapAllocated();
+	if (allocated_after > allocated) {
+		stats.allocated_max = MAX(stats.allocated_max, allocated_after - allocated);
+	}
+
+	if (stats.runs == CONFIG_APP_SIM_BENCH_ITERATIONS) {
+		k_work_cancel_delayable(&measure_work);
+		k_work_submit(&finish_work);
+	}
+}
+
+} // namespace
+
+void AppTask::MeasureWorkPeriodic(struct k_work *work)
+{
+	int16_t temperature;
+	uint16_t humidity;
+	bool success = measure_pipeline.Read(temperature, humidity, interval.Stable(), true);
+
+	measure_pipeline.Report(success, temperature, humidity, attributes);
+
+	if (success) {
+		interval.Update(temperature, humidity, interval.IntervalSec() * 1000LL);
+	} else {
+		stats.failures++;
+	}
+
+	if (attributes.dirty) {
+		k_work_submit(&report_work);
+	}
+
+	k_work_reschedule(&measure_work, K_SECONDS(interval.IntervalSec()));
+}
+
+CHIP_ERROR AppTask::Init()
+{
+	ReturnErrorOnFailure(sht4x.Init());
+	interval.Init();
+
+	measure_handler = MeasureWorkPeriodic;
+	k_work_init_delayable(&measure_work, BenchWork);
+	k_work_init(&report_work, ReportWork);
+	k_work_init(&stall_probe, StallProbe);
+	k_work_init(&finish_work, FinishWork);
+
+	return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR AppTask::StartApp()
+{
+	ReturnErrorOnFailure(Init());
+
+	LOG_INF("native_sim: measuring every %u s", interval.IntervalSec());
+	k_work_schedule(&measure_work, K_NO_WAIT);
+
+	// Like the Matter event loop on target, never returns
+	k_sleep(K_FOREVER);
+
+	return CHIP_NO_ERROR;
+}
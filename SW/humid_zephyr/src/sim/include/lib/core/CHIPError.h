@@ -0,0 +1,35 @@
+#pragma once
+
+// Stand-in for the Matter error type in the native_sim build, which has no
+// Matter stack. Only what the shared sources use.
+
+#include <inttypes.h>
+#include <stdint.h>
+
+namespace chip {
+
+class ChipError {
+public:
+	using StorageType = uint32_t;
+
+	constexpr ChipError() = default;
+	constexpr explicit ChipError(StorageType value) : value(value) {}
+
+	constexpr bool operator==(const ChipError &other) const { return value == other.value; }
+	constexpr bool operator!=(const ChipError &other) const { return value != other.value; }
+
+	constexpr bool IsSuccess() const { return value == 0; }
+	constexpr StorageType AsInteger() const { return value; }
+	constexpr StorageType Format() const { return value; }
+
+private:
+	StorageType value = 0;
+};
+
+} // namespace chip
+
+using CHIP_ERROR = ::chip::ChipError;
+
+#define CHIP_NO_ERROR CHIP_ERROR(0)
+#define CHIP_ERROR_INTERNAL CHIP_ERROR(0xAC)
+#define CHIP_ERROR_FORMAT PRIx32
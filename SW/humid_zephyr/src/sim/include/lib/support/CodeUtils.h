@@ -0,0 +1,20 @@
+#pragma once
+
+// Stand-in for the Matter error handling macros in the native_sim build
+
+#include <lib/core/CHIPError.h>
+
+#define ReturnErrorOnFailure(expr) \
+	do { \
+		CHIP_ERROR __err = (expr); \
+		if (!__err.IsSuccess()) { \
+			return __err; \
+		} \
+	} while (false)
+
+#define VerifyOrReturnError(expr, code) \
+	do { \
+		if (!(expr)) { \
+			return (code); \
+		} \
+	} while (false)
@@ -0,0 +1,232 @@
+/*
+ * SHT4x emulator for native_sim
+ *
+ * Answers the single shot measurement, heater, soft reset and serial number
+ * commands with CRC protected data, following a scripted bathroom profile:
+ * a hot shower every three hours drives RH into condensation, where readings
+ * creep high until a heater pulse dries the sensor off.
+ */
+
+#define DT_DRV_COMPAT sensirion_sht4x
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_REGISTER(sht4x_emul, CONFIG_CHIP_APP_LOG_LEVEL);
+
+#define SHT4X_CRC_POLY 0x31
+#define SHT4X_CRC_INIT 0xFF
+
+#define SHT4X_CMD_SOFT_RESET 0x94
+#define SHT4X_CMD_SERIAL     0x89
+
+/* Above this RH condensation on the sensor makes RH readings creep high */
+#define CONDENSATION_RH     9500
+/* Creep per minute spent in condensation, in 0.01 %RH */
+#define CONDENSATION_CREEP  50
+#define CONDENSATION_MAX    1500
+
+struct profile_point {
+	uint16_t minute;
+	int16_t temperature; /* 0.01 C */
+	uint16_t humidity;   /* 0.01 %RH */
+};
+
+/* Linear between points, repeats every PROFILE_PERIOD_MIN */
+static const struct profile_point profile[] = {
+	{0, 2100, 4500},
+	{60, 2100, 4600},
+	{65, 2500, 9500},
+	{80, 2550, 9900},
+	{110, 2250, 6500},
+	{150, 2120, 4800},
+	{180, 2100, 4500},
+};
+
+#define PROFILE_PERIOD_MIN 180
+
+struct command {
+	uint8_t command;
+	/* Noise amplitude, 0.01 units */
+	uint8_t temperature_noise;
+	uint8_t humidity_noise;
+	/* Self heating by the end of a heater pulse, 0.01 C */
+	uint16_t heater_rise;
+};
+
+static const struct command commands[] = {
+	/* Measurements, datasheet table 1 */
+	{0xFD, 4, 8, 0},
+	{0xF6, 7, 15, 0},
+	{0xE0, 10, 25, 0},
+	/* Heater pulses followed by a high repeatability measurement, 200/110/20 mW */
+	{0x39, 4, 8, 6000},
+	{0x32, 4, 8, 1500},
+	{0x2F, 4, 8, 3300},
+	{0x24, 4, 8, 800},
+	{0x1E, 4, 8, 600},
+	{0x15, 4, 8, 150},
+};
+
+struct sht4x_emul_data {
+	const struct command *pending;
+	bool serial_pending;
+	uint32_t transfers;
+	uint32_t rand;
+	/* RH offset from condensation, cleared by heater pulses */
+	int32_t creep;
+	int64_t last_update_ms;
+};
+
+static const struct command *find_command(uint8_t command)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(commands); i++) {
+		if (commands[i].command == command) {
+			return &commands[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void profile_at(int64_t uptime_ms, int32_t *temperature, int32_t *humidity)
+{
+	int32_t ms = uptime_ms % (PROFILE_PERIOD_MIN * 60000LL);
+
+	for (size_t i = 1; i < ARRAY_SIZE(profile); i++) {
+		int32_t start = profile[i - 1].minute * 60000;
+		int32_t end = profile[i].minute * 60000;
+
+		if (ms < end) {
+			*temperature = profile[i - 1].temperature +
+				       (int64_t)(profile[i].temperature - profile[i - 1].temperature) *
+					       (ms - start) / (end - start);
+			*humidity = profile[i - 1].humidity +
+				    (int64_t)(profile[i].humidity - profile[i - 1].humidity) * (ms - start) /
+					    (end - start);
+			return;
+		}
+	}
+
+	*temperature = profile[0].temperature;
+	*humidity = profile[0].humidity;
+}
+
+/* Deterministic noise in [-amplitude, amplitude], so runs are reproducible */
+static int32_t noise(struct sht4x_emul_data *data, int32_t amplitude)
+{
+	data->rand = data->rand * 1103515245 + 12345;
+	return (int32_t)((data->rand >> 16) % (2 * amplitude + 1)) - amplitude;
+}
+
+static void put_word(uint8_t *buf, uint16_t value)
+{
+	sys_put_be16(value, buf);
+	buf[2] = crc8(buf, 2, SHT4X_CRC_POLY, SHT4X_CRC_INIT, false);
+}
+
+static void measure(struct sht4x_emul_data *data, const struct command *command, uint8_t *buf)
+{
+	int64_t now = k_uptime_get();
+	int32_t temperature;
+	int32_t humidity;
+
+	profile_at(now, &temperature, &humidity);
+
+	if (humidity >= CONDENSATION_RH) {
+		data->creep += CONDENSATION_CREEP * (now - data->last_update_ms) / 60000;
+		data->creep = MIN(data->creep, CONDENSATION_MAX);
+	}
+	data->last_update_ms = now;
+
+	if (command->heater_rise) {
+		/* Measured at the end of the pulse: hotter, so relatively drier,
+		 * roughly 6 %RH less per degree around room temperature
+		 */
+		temperature += command->heater_rise;
+		humidity = humidity * MAX(100 - 6 * command->heater_rise / 100, 0) / 100;
+		data->creep = 0;
+	}
+
+	temperature += noise(data, command->temperature_noise);
+	humidity += data->creep + noise(data, command->humidity_noise);
+
+	/* Datasheet section 4.6, inverted */
+	put_word(&buf[0], CLAMP((temperature + 4500) * 65535 / 17500, 0, 65535));
+	put_word(&buf[3], CLAMP((humidity + 600) * 65535 / 12500, 0, 65535));
+}
+
+static int sht4x_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs, int addr)
+{
+	struct sht4x_emul_data *data = target->data;
+
+	for (int i = 0; i < num_msgs; i++) {
+		data->transfers++;
+		if (CONFIG_APP_SIM_SHT4X_FAIL_EVERY > 0 &&
+		    data->transfers % CONFIG_APP_SIM_SHT4X_FAIL_EVERY == 0) {
+			return -EIO;
+		}
+
+		if ((msgs[i].flags & I2C_MSG_RW_MASK) == I2C_MSG_WRITE) {
+			if (msgs[i].len != 1) {
+				return -EIO;
+			}
+
+			uint8_t command = msgs[i].buf[0];
+
+			data->pending = find_command(command);
+			data->serial_pending = command == SHT4X_CMD_SERIAL;
+			if (command == SHT4X_CMD_SOFT_RESET) {
+				data->creep = 0;
+			} else if (!data->pending && !data->serial_pending) {
+				LOG_WRN("Unsupported command 0x%02x", command);
+				return -EIO;
+			}
+			continue;
+		}
+
+		/* Reads are NACKed until a command has been issued */
+		if (msgs[i].len != 6 || (!data->pending && !data->serial_pending)) {
+			return -EIO;
+		}
+
+		if (data->serial_pending) {
+			put_word(&msgs[i].buf[0], 0x5348);
+			put_word(&msgs[i].buf[3], 0x5434);
+		} else {
+			measure(data, data->pending, msgs[i].buf);
+		}
+		data->pending = NULL;
+		data->serial_pending = false;
+	}
+
+	return 0;
+}
+
+static const struct i2c_emul_api sht4x_emul_api = {
+	.transfer = sht4x_emul_transfer,
+};
+
+static int sht4x_emul_init(const struct emul *target, const struct device *parent)
+{
+	struct sht4x_emul_data *data = target->data;
+
+	ARG_UNUSED(parent);
+
+	data->rand = 1;
+
+	return 0;
+}
+
+#define SHT4X_EMUL(n)                                                                                  \
+	static struct sht4x_emul_data sht4x_emul_data_##n;                                             \
+	EMUL_DT_INST_DEFINE(n, sht4x_emul_init, &sht4x_emul_data_##n, NULL, &sht4x_emul_api, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(SHT4X_EMUL)
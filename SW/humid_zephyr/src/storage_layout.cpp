@@ -0,0 +1,132 @@
+#include "storage_layout.h"
+
+#if CONFIG_APP_STORAGE_LAYOUT_MIGRATION
+
+#include <pm_config.h>
+
+#include <zephyr/logging/log.h>
+#include <zephyr/storage/flash_map.h>
+
+#include <string.h>
+
+LOG_MODULE_REGISTER(storage_layout, CONFIG_CHIP_APP_LOG_LEVEL);
+
+namespace {
+
+constexpr uint32_t kMagic = 0x534c4159; // "SLAY"
+
+// Bump with every change to settings_storage, sample_log or checkpoint_storage
+constexpr uint32_t kVersion = 1;
+
+struct Marker {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t reserved[6];
+};
+
+static_assert(sizeof(Marker) == kStorageLayoutMarkerSize, "Marker must fill its reserved space");
+
+constexpr off_t kMarkerOffset = PM_CHECKPOINT_STORAGE_SIZE - kStorageLayoutMarkerSize;
+
+// Allocation table entry as ZMS writes it, see subsys/fs/zms/zms_priv.h
+struct ZmsAte {
+	uint8_t crc8;
+	uint8_t cycle_cnt;
+	uint16_t len;
+	uint32_t id;
+	uint32_t offset;
+	uint32_t metadata;
+};
+
+constexpr uint32_t kZmsHeadId = UINT32_MAX;
+constexpr uint8_t kZmsMagic = 0x42;
+
+static_assert(PM_SETTINGS_STORAGE_ADDRESS + PM_SETTINGS_STORAGE_SIZE == PM_SAMPLE_LOG_ADDRESS &&
+		      PM_SAMPLE_LOG_ADDRESS + PM_SAMPLE_LOG_SIZE == PM_CHECKPOINT_STORAGE_ADDRESS,
+	      "The migration expects both partitions right behind settings_storage");
+
+// ZMS ends every sector it opened with an empty ATE
+bool EndsLikeZmsSector(uint8_t id, const char *name)
+{
+	const struct flash_area *area;
+	ZmsAte ate;
+
+	if (flash_area_open(id, &area) != 0) {
+		return false;
+	}
+
+	int ret = flash_area_read(area, area->fa_size - sizeof(ate), &ate, sizeof(ate));
+
+	flash_area_close(area);
+
+	if (ret != 0 || ate.id != kZmsHeadId || ate.len != UINT16_MAX || ((ate.metadata >> 8) & 0xff) != kZmsMagic) {
+		return false;
+	}
+
+	LOG_WRN("Settings sector found in %s", name);
+
+	return true;
+}
+
+bool Erase(uint8_t id, const char *name)
+{
+	const struct flash_area *area;
+	int ret = flash_area_open(id, &area);
+
+	if (ret == 0) {
+		ret = flash_area_erase(area, 0, area->fa_size);
+		flash_area_close(area);
+	}
+
+	if (ret != 0) {
+		LOG_ERR("Failed to erase %s: %d", name, ret);
+	}
+
+	return ret == 0;
+}
+
+} // namespace
+
+void StorageLayoutMigrate()
+{
+	const struct flash_area *area;
+	Marker marker = {};
+
+	if (flash_area_open(PM_CHECKPOINT_STORAGE_ID, &area) != 0) {
+		LOG_ERR("Failed to open checkpoint storage");
+		return;
+	}
+
+	if (flash_area_read(area, kMarkerOffset, &marker, sizeof(marker)) == 0 && marker.magic == kMagic &&
+	    marker.version == kVersion) {
+		flash_area_close(area);
+		return;
+	}
+
+	bool old_layout = EndsLikeZmsSector(PM_SAMPLE_LOG_ID, "sample_log") ||
+			  EndsLikeZmsSector(PM_CHECKPOINT_STORAGE_ID, "checkpoint_storage");
+
+	if (old_layout) {
+		LOG_WRN("Old storage layout, erasing settings for layout %u", kVersion);
+
+		// The old sectors go last: if this is cut short, the next boot
+		// still finds them and starts over
+		if (!Erase(PM_SETTINGS_STORAGE_ID, "settings_storage") || !Erase(PM_SAMPLE_LOG_ID, "sample_log") ||
+		    !Erase(PM_CHECKPOINT_STORAGE_ID, "checkpoint_storage")) {
+			flash_area_close(area);
+			return;
+		}
+	}
+
+	memset(&marker, 0, sizeof(marker));
+	marker.magic = kMagic;
+	marker.version = kVersion;
+
+	if (flash_area_write(area, kMarkerOffset, &marker, sizeof(marker)) != 0) {
+		LOG_ERR("Failed to write storage layout");
+	}
+
+	flash_area_close(area);
+}
+
+#endif // CONFIG_APP_STORAGE_LAYOUT_MIGRATION
@@ -0,0 +1,29 @@
+#pragma once
+
+// One migration for the internal layout, where sample_log and
+// checkpoint_storage had to be cut from the end of settings_storage
+// (0x6000 to 0x4000). A device updated over the air from the old layout may
+// have settings records where the new partitions are.
+//
+// The layout version is kept in the last 32 bytes of checkpoint_storage,
+// outside the settings. When it is missing the old layout is only assumed if
+// either new partition ends like a settings sector, ZMS closes every sector
+// it used with an ATE in its last word. Then settings_storage, sample_log
+// and checkpoint_storage are erased, the device comes up factory new and has
+// to be commissioned again. Settings that never reached the cut stay.
+//
+// The version is written last, so a boot that is cut short during the erase
+// starts over. If only writing the version failed, the next boot finds no
+// old sectors left and just writes it again.
+
+#include <stddef.h>
+
+// Reserved at the end of checkpoint_storage
+constexpr size_t kStorageLayoutMarkerSize = 32;
+
+#if CONFIG_APP_STORAGE_LAYOUT_MIGRATION
+// Call first thing in main(), before the settings are loaded
+void StorageLayoutMigrate();
+#else
+inline void StorageLayoutMigrate() {}
+#endif // CONFIG_APP_STORAGE_LAYOUT_MIGRATION
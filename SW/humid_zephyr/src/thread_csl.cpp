@@ -0,0 +1,214 @@
+#include "thread_csl.h"
+
+#if CONFIG_APP_THREAD_CSL
+
+#include <app/server/Server.h>
+#include <lib/support/CodeUtils.h>
+#include <platform/CHIPDeviceLayer.h>
+#include <platform/ThreadStackManager.h>
+
+#include <openthread/link.h>
+#include <openthread/thread.h>
+#include <openthread/platform/radio.h>
+
+#if CONFIG_OPENTHREAD_RADIO_STATS
+#include <openthread/radio_stats.h>
+#endif
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <string.h>
+
+LOG_MODULE_REGISTER(thread_csl, CONFIG_CHIP_APP_LOG_LEVEL);
+
+using namespace ::chip;
+using namespace ::chip::DeviceLayer;
+
+// The CSL IE carries the period in units of 10 symbols in 16 bits
+constexpr uint64_t kMaxCslPeriodUs = uint64_t(UINT16_MAX) * OT_US_PER_TEN_SYMBOLS;
+
+// CSL periods between checks, and without a frame before polls resume
+constexpr uint32_t kSilentPeriods = 8;
+
+CHIP_ERROR ThreadCsl::Init()
+{
+	start = Take();
+
+	// Returns nullptr once CHIP_CONFIG_ICD_OBSERVERS_POOL_SIZE observers are registered
+	VerifyOrReturnError(Server::GetInstance().GetICDManager().RegisterObserver(this) != nullptr,
+			    CHIP_ERROR_NO_MEMORY);
+
+	return CHIP_NO_ERROR;
+}
+
+void ThreadCsl::OnEnterActiveMode()
+{
+	// The ICD manager sets the fast poll period before it notifies observers,
+	// pick it up once they all ran
+	SystemLayer().ScheduleLambda([this] { Apply(true); });
+}
+
+void ThreadCsl::OnEnterIdleMode()
+{
+	// The power policy may scale the slow poll period in its own observer
+	SystemLayer().ScheduleLambda([this] { Apply(false); });
+}
+
+void ThreadCsl::CheckTimerHandler(System::Layer *layer, void *context)
+{
+	static_cast<ThreadCsl *>(context)->Check();
+}
+
+ThreadCsl::Sample ThreadCsl::Take()
+{
+	Sample sample = {};
+
+	sample.uptime_ms = k_uptime_get();
+
+	ThreadStackMgr().LockThreadStack();
+
+	otInstance *instance = ThreadStackMgrImpl().OTInstance();
+	const otMacCounters *mac = otLinkGetCounters(instance);
+
+	sample.tx_frames = mac->mTxTotal;
+	sample.rx_frames = mac->mRxTotal;
+
+#if CONFIG_OPENTHREAD_RADIO_STATS
+	const otRadioTimeStats *time = otRadioTimeStatsGet(instance);
+
+	sample.tx_us = time->mTxTime;
+	sample.rx_us = time->mRxTime;
+#endif
+
+	ThreadStackMgr().UnlockThreadStack();
+
+	return sample;
+}
+
+void ThreadCsl::Apply(bool now_active)
+{
+	Sample now = Take();
+	uint32_t elapsed_ms = static_cast<uint32_t>(now.uptime_ms - start.uptime_ms);
+
+	if (period_ms > 0 && elapsed_ms > 0) {
+		LOG_INF("%s period over %s %u ms: %u ms, %u frames sent, %u received", active ? "Active" : "Idle",
+			!csl ? "polling" : confirmed ? "CSL" : "CSL and polling", period_ms, elapsed_ms,
+			now.tx_frames - start.tx_frames, now.rx_frames - start.rx_frames);
+#if CONFIG_OPENTHREAD_RADIO_STATS
+		uint64_t tx_us = now.tx_us - start.tx_us;
+		uint64_t rx_us = now.rx_us - start.rx_us;
+		uint64_t charge_pc = tx_us * CONFIG_APP_RADIO_TX_CURRENT_UA + rx_us * CONFIG_APP_RADIO_RX_CURRENT_UA;
+
+		LOG_INF("Radio on %u us transmitting, %u us receiving, %u nA average radio current estimated",
+			static_cast<uint32_t>(tx_us), static_cast<uint32_t>(rx_us),
+			static_cast<uint32_t>(charge_pc / elapsed_ms));
+#endif
+	}
+
+	start = now;
+	active = now_active;
+
+	SystemLayer().CancelTimer(CheckTimerHandler, this);
+
+	ThreadStackMgr().LockThreadStack();
+
+	otInstance *instance = ThreadStackMgrImpl().OTInstance();
+	uint32_t icd_poll_ms = otLinkGetPollPeriod(instance);
+	uint64_t csl_us = uint64_t(icd_poll_ms) * USEC_PER_MSEC;
+	otRouterInfo info;
+	bool attached = otThreadGetParentInfo(instance, &info) == OT_ERROR_NONE;
+	bool capable = attached && info.mVersion >= OT_THREAD_VERSION_1_2;
+
+	// Delivery in CSL windows has to be seen again from a new parent
+	if (!attached || memcmp(&info.mExtAddress, &parent, sizeof(parent)) != 0) {
+		confirmed = false;
+		parent = attached ? info.mExtAddress : otExtAddress{};
+	}
+
+	csl = false;
+
+	if (capable && icd_poll_ms > 0 && csl_us <= kMaxCslPeriodUs) {
+		csl_us -= csl_us % OT_US_PER_TEN_SYMBOLS;
+		csl = otLinkSetCslPeriod(instance, static_cast<uint32_t>(csl_us)) == OT_ERROR_NONE &&
+		      otLinkIsCslEnabled(instance);
+	}
+
+	if (!csl) {
+		otLinkSetCslPeriod(instance, 0);
+	} else if (confirmed) {
+		// Polls only keep the link alive, the ICD manager sets its period
+		// again on the next transition
+		otLinkSetPollPeriod(instance, 0);
+	}
+
+	const otMacCounters *mac = otLinkGetCounters(instance);
+
+	check_rx_unicast = mac->mRxUnicast;
+	check_rx_frames = mac->mRxTotal;
+	check_polls = mac->mTxDataPoll;
+
+	ThreadStackMgr().UnlockThreadStack();
+
+	// Only reported once, the parent rarely changes
+	if (attached && !capable && !parent_logged) {
+		parent_logged = true;
+		LOG_INF("Parent runs Thread version %u without CSL, polling", info.mVersion);
+	}
+
+	if (icd_poll_ms > 0) {
+		period_ms = icd_poll_ms;
+		poll_ms = icd_poll_ms;
+	}
+
+	if (csl) {
+		csl_ms = static_cast<uint32_t>(csl_us / USEC_PER_MSEC);
+		SystemLayer().StartTimer(System::Clock::Milliseconds32(csl_ms * kSilentPeriods), CheckTimerHandler,
+					 this);
+	}
+}
+
+void ThreadCsl::Check()
+{
+	if (!csl) {
+		return;
+	}
+
+	ThreadStackMgr().LockThreadStack();
+
+	otInstance *instance = ThreadStackMgrImpl().OTInstance();
+	const otMacCounters *mac = otLinkGetCounters(instance);
+	uint32_t rx_unicast = mac->mRxUnicast - check_rx_unicast;
+	uint32_t rx_frames = mac->mRxTotal - check_rx_frames;
+	uint32_t polls = mac->mTxDataPoll - check_polls;
+	bool changed = false;
+
+	check_rx_unicast = mac->mRxUnicast;
+	check_rx_frames = mac->mRxTotal;
+	check_polls = mac->mTxDataPoll;
+
+	if (!confirmed && rx_unicast > polls) {
+		// A data poll fetches one frame, the others came in CSL windows
+		confirmed = true;
+		changed = true;
+		otLinkSetPollPeriod(instance, 0);
+	} else if (confirmed && rx_frames == 0) {
+		// Quiet, or the parent stopped serving our CSL windows. Poll at
+		// the ICD period until a frame shows up in one again.
+		confirmed = false;
+		changed = true;
+		otLinkSetPollPeriod(instance, poll_ms);
+	}
+
+	ThreadStackMgr().UnlockThreadStack();
+
+	if (changed && confirmed) {
+		LOG_INF("Parent sends in CSL windows, data polls off");
+	} else if (changed) {
+		LOG_DBG("No frame in %u CSL periods, polling every %u ms", kSilentPeriods, poll_ms);
+	}
+
+	SystemLayer().StartTimer(System::Clock::Milliseconds32(csl_ms * kSilentPeriods), CheckTimerHandler, this);
+}
+
+#endif // CONFIG_APP_THREAD_CSL
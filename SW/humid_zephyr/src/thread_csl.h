@@ -0,0 +1,84 @@
+#pragma once
+
+// Thread 1.2 CSL receiver. Instead of sending a data poll every poll
+// period, the radio opens a short receive window every CSL period, at times
+// the parent learned from our CSL IE, and the parent sends queued frames in
+// them. Whenever the ICD changes the poll period, the same interval is
+// offered as CSL period:
+// - the parent runs Thread 1.1, or CSL could not be enabled: data polls
+//   stay as the ICD set them,
+// - the interval is longer than the longest CSL period, about 10.5 s, as
+//   the slow poll of a LIT device is: one poll per interval is cheaper than
+//   listening more often, data polls stay as well,
+// - otherwise CSL runs next to the data polls until the parent delivers a
+//   frame no poll asked for. Only then data polls fall back to the
+//   keep-alive rate. When no frame arrives for 8 CSL periods,
+//   polls resume until the parent is seen delivering in CSL windows again,
+//   so a parent that accepted the period but does not serve it delays
+//   downlink traffic by that much at most.
+// The time, frames and radio on time of each period are logged with the
+// mode it ran in. With OPENTHREAD_RADIO_STATS an average radio current is
+// estimated from the datasheet currents, it is not a measurement.
+
+#include <lib/core/CHIPError.h>
+
+#if CONFIG_APP_THREAD_CSL
+
+#include <app/icd/server/ICDStateObserver.h>
+#include <system/SystemLayer.h>
+
+#include <openthread/thread.h>
+
+#include <stdint.h>
+
+class ThreadCsl : public chip::app::ICDStateObserver {
+public:
+	// Call after Server::Init()
+	CHIP_ERROR Init();
+
+	void OnEnterActiveMode() override;
+	void OnTransitionToIdle() override {}
+	void OnEnterIdleMode() override;
+	void OnICDModeChange() override {}
+
+private:
+	struct Sample {
+		int64_t uptime_ms;
+		uint32_t tx_frames;
+		uint32_t rx_frames;
+		uint64_t tx_us;
+		uint64_t rx_us;
+	};
+
+	static void CheckTimerHandler(chip::System::Layer *layer, void *context);
+
+	// Picks CSL or polling for the poll period the ICD just set
+	void Apply(bool active);
+	Sample Take();
+	// Confirms CSL delivery, or goes back to polling after a silence
+	void Check();
+
+	Sample start = {};
+	uint32_t period_ms = 0;
+	uint32_t poll_ms = 0;
+	uint32_t csl_ms = 0;
+	bool active = true;
+	bool csl = false;
+	// The parent was seen sending in our CSL windows, data polls are off
+	bool confirmed = false;
+	bool parent_logged = false;
+	otExtAddress parent = {};
+	// At the last Check()
+	uint32_t check_rx_unicast = 0;
+	uint32_t check_rx_frames = 0;
+	uint32_t check_polls = 0;
+};
+
+#else
+
+class ThreadCsl {
+public:
+	CHIP_ERROR Init() { return CHIP_NO_ERROR; }
+};
+
+#endif // CONFIG_APP_THREAD_CSL
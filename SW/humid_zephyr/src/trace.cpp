@@ -0,0 +1,202 @@
+#include "trace.h"
+
+#if CONFIG_APP_TRACE
+
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+#include <string.h>
+
+#if CONFIG_NRF_GRTC_TIMER
+#include <zephyr/drivers/timer/nrf_grtc_timer.h>
+#endif
+
+LOG_MODULE_REGISTER(trace, CONFIG_CHIP_APP_LOG_LEVEL);
+
+#define TRACE_NODE DT_NODELABEL(trace_ram)
+#define TRACE_ADDR (DT_REG_ADDR(DT_NODELABEL(retained_sram)) + DT_REG_ADDR(TRACE_NODE))
+#define TRACE_SIZE DT_REG_SIZE(TRACE_NODE)
+
+namespace {
+
+constexpr uint32_t kMagic = 0x54524331; // "TRC1"
+
+enum Event : uint8_t {
+	kBegin,
+	kEnd,
+};
+
+struct Record {
+	// GRTC timestamp in us, the GRTC keeps counting through System OFF
+	uint32_t timestamp_us;
+	uint8_t phase;
+	uint8_t event;
+	uint16_t boot;
+};
+
+struct Ring {
+	uint32_t magic;
+	uint32_t boot_count;
+	uint32_t head;
+	uint32_t reserved;
+	Record records[(TRACE_SIZE - 16) / sizeof(Record)];
+};
+
+static_assert(sizeof(Ring) <= TRACE_SIZE, "Trace ring does not fit trace_ram");
+
+Ring *const ring = reinterpret_cast<Ring *>(TRACE_ADDR);
+
+uint32_t begin_us[static_cast<size_t>(TracePhase::kCount)];
+uint32_t last_duration_us[static_cast<size_t>(TracePhase::kCount)];
+atomic_t open_phases;
+
+#if CONFIG_APP_TRACE_GPIO
+const struct gpio_dt_spec marker = GPIO_DT_SPEC_GET(DT_PATH(zephyr_user), trace_gpios);
+#endif
+
+uint32_t Now()
+{
+#if CONFIG_NRF_GRTC_TIMER
+	return static_cast<uint32_t>(z_nrf_grtc_timer_read());
+#else
+	return static_cast<uint32_t>(k_cyc_to_us_floor64(k_cycle_get_64()));
+#endif
+}
+
+void Append(TracePhase phase, Event event, uint32_t now)
+{
+	unsigned int key = irq_lock();
+	Record &record = ring->records[ring->head % ARRAY_SIZE(ring->records)];
+
+	record.timestamp_us = now;
+	record.phase = static_cast<uint8_t>(phase);
+	record.event = event;
+	record.boot = static_cast<uint16_t>(ring->boot_count);
+	ring->head++;
+	irq_unlock(key);
+}
+
+} // namespace
+
+void TraceInit()
+{
+	if (ring->magic != kMagic) {
+		memset(ring, 0, sizeof(*ring));
+		ring->magic = kMagic;
+	}
+	ring->boot_count++;
+
+#if CONFIG_APP_TRACE_GPIO
+	if (!gpio_is_ready_dt(&marker) || gpio_pin_configure_dt(&marker, GPIO_OUTPUT_INACTIVE) != 0) {
+		LOG_ERR("Failed to configure trace marker GPIO");
+	}
+#endif
+}
+
+void TraceBegin(TracePhase phase)
+{
+	uint32_t now = Now();
+
+#if CONFIG_APP_TRACE_GPIO
+	// Every event is an edge on the marker
+	gpio_pin_toggle_dt(&marker);
+#endif
+
+	begin_us[static_cast<size_t>(phase)] = now;
+	atomic_set_bit(&open_phases, static_cast<int>(phase));
+	Append(phase, kBegin, now);
+}
+
+void TraceEnd(TracePhase phase)
+{
+	uint32_t now = Now();
+
+#if CONFIG_APP_TRACE_GPIO
+	gpio_pin_toggle_dt(&marker);
+#endif
+
+	if (atomic_test_and_clear_bit(&open_phases, static_cast<int>(phase))) {
+		last_duration_us[static_cast<size_t>(phase)] = now - begin_us[static_cast<size_t>(phase)];
+	}
+	Append(phase, kEnd, now);
+}
+
+uint32_t TraceLastDurationUs(TracePhase phase)
+{
+	return last_duration_us[static_cast<size_t>(phase)];
+}
+
+uint32_t TraceBootCount()
+{
+	return ring->boot_count;
+}
+
+#ifdef CONFIG_SHELL
+
+#include <zephyr/shell/shell.h>
+
+namespace {
+
+const char *const kPhaseNames[] = {
+	"boot", "chip_init", "sensor_init", "sensor_fetch", "heater", "attribute_set", "icd_active",
+	"leak_report",
+};
+
+static_assert(ARRAY_SIZE(kPhaseNames) == static_cast<size_t>(TracePhase::kCount));
+
+static int DumpCommand(const struct shell *shell, size_t argc, char **argv)
+{
+	uint32_t count = MIN(ring->head, ARRAY_SIZE(ring->records));
+	uint32_t begin[static_cast<size_t>(TracePhase::kCount)] = {};
+
+	shell_print(shell, "boot count %u, %u records", ring->boot_count, count);
+
+	for (uint32_t i = ring->head - count; i != ring->head; i++) {
+		const Record &record = ring->records[i % ARRAY_SIZE(ring->records)];
+
+		if (record.phase >= ARRAY_SIZE(kPhaseNames)) {
+			continue;
+		}
+
+		if (record.event == kBegin) {
+			begin[record.phase] = record.timestamp_us;
+			shell_print(shell, "%5u %10u us  %-13s begin", record.boot, record.timestamp_us,
+				    kPhaseNames[record.phase]);
+		} else {
+			shell_print(shell, "%5u %10u us  %-13s end    %u us", record.boot, record.timestamp_us,
+				    kPhaseNames[record.phase], record.timestamp_us - begin[record.phase]);
+		}
+	}
+
+	return 0;
+}
+
+static int ClearCommand(const struct shell *shell, size_t argc, char **argv)
+{
+	unsigned int key = irq_lock();
+	ring->head = 0;
+	ring->boot_count = 0;
+	irq_unlock(key);
+
+	shell_print(shell, "Trace cleared");
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+	trace_cmds,
+	SHELL_CMD(dump, NULL, "Print the wake cycle trace, oldest first", DumpCommand),
+	SHELL_CMD(clear, NULL, "Clear the wake cycle trace", ClearCommand),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(trace, &trace_cmds, "Wake cycle phase trace", NULL);
+
+} // namespace
+
+#endif // CONFIG_SHELL
+
+#endif // CONFIG_APP_TRACE
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdint.h>
+
+// Phases of the wake cycle, traced to find where active time goes
+enum class TracePhase : uint8_t {
+	kBoot,         // main() until the application is initialized
+	kChipInit,     // Matter server init
+	kSensorInit,   // Sht4x::Init
+	kSensorFetch,  // SHT4x conversion and readout
+	kHeater,       // SHT4x heater pulse
+	kAttributeSet, // Writing measurements to the data model
+	kIcdActive,    // ICD active mode, reports are sent and received in this window
+	kLeakReport,   // Leak probe edge until the StateChange event is logged and reports scheduled
+	kCount,
+};
+
+#if CONFIG_APP_TRACE
+
+// Timestamp the start and end of a phase into the retained RAM trace ring.
+// Safe to call from any context, a couple of register reads and an 8 byte store.
+void TraceBegin(TracePhase phase);
+void TraceEnd(TracePhase phase);
+
+// Duration of the last completed phase in us, 0 if it never completed since boot
+uint32_t TraceLastDurationUs(TracePhase phase);
+
+// Number of boots the trace ring has seen since it was cleared
+uint32_t TraceBootCount();
+
+void TraceInit();
+
+#else
+
+inline void TraceBegin(TracePhase phase) {}
+inline void TraceEnd(TracePhase phase) {}
+inline uint32_t TraceLastDurationUs(TracePhase phase)
+{
+	return 0;
+}
+inline uint32_t TraceBootCount()
+{
+	return 0;
+}
+inline void TraceInit() {}
+
+#endif // CONFIG_APP_TRACE
+
+// Traces the enclosing scope as one phase
+class TraceScope {
+public:
+	explicit TraceScope(TracePhase phase) : phase(phase) { TraceBegin(phase); }
+	~TraceScope() { TraceEnd(phase); }
+
+	TraceScope(const TraceScope &) = delete;
+	TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+	TracePhase phase;
+};
@@ -0,0 +1,194 @@
+#include "tx_power.h"
+
+#if CONFIG_APP_TX_POWER_CONTROL
+
+#include <app/server/Server.h>
+#include <lib/support/CodeUtils.h>
+#include <platform/CHIPDeviceLayer.h>
+#include <platform/ThreadStackManager.h>
+
+#include <openthread/link.h>
+#include <openthread/platform/radio.h>
+
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+#include <string.h>
+
+LOG_MODULE_REGISTER(tx_power, CONFIG_CHIP_APP_LOG_LEVEL);
+
+using namespace ::chip;
+using namespace ::chip::DeviceLayer;
+
+constexpr int kStepUpDb = 3;
+constexpr int kStepDownDb = 1;
+
+// Below this, fading takes frames out faster than the retry rate shows it
+constexpr int kMinMarginDb = 6;
+
+// Windows until a power that failed the target is tried again
+constexpr uint16_t kFloorWindows = 32;
+
+CHIP_ERROR TxPower::Init()
+{
+	ThreadStackMgr().LockThreadStack();
+
+	otInstance *instance = ThreadStackMgrImpl().OTInstance();
+
+	if (otPlatRadioGetTransmitPower(instance, &power_dbm) != OT_ERROR_NONE) {
+		power_dbm = CONFIG_OPENTHREAD_DEFAULT_TX_POWER;
+	}
+
+	start = Take(instance);
+	CheckParent(instance);
+
+	ThreadStackMgr().UnlockThreadStack();
+
+	ReturnErrorOnFailure(PlatformMgr().AddEventHandler(ChipEventHandler, reinterpret_cast<intptr_t>(this)));
+
+	// Returns nullptr once CHIP_CONFIG_ICD_OBSERVERS_POOL_SIZE observers are registered
+	VerifyOrReturnError(Server::GetInstance().GetICDManager().RegisterObserver(this) != nullptr,
+			    CHIP_ERROR_NO_MEMORY);
+
+	return CHIP_NO_ERROR;
+}
+
+void TxPower::OnEnterIdleMode()
+{
+	Evaluate();
+}
+
+void TxPower::ChipEventHandler(const ChipDeviceEvent *event, intptr_t arg)
+{
+	if (event->Type != DeviceEventType::kThreadStateChange || !event->ThreadStateChange.RoleChanged) {
+		return;
+	}
+
+	TxPower *tx_power = reinterpret_cast<TxPower *>(arg);
+
+	ThreadStackMgr().LockThreadStack();
+	tx_power->CheckParent(ThreadStackMgrImpl().OTInstance());
+	ThreadStackMgr().UnlockThreadStack();
+}
+
+TxPower::Counters TxPower::Take(otInstance *instance)
+{
+	const otMacCounters *mac = otLinkGetCounters(instance);
+	Counters counters;
+
+	// Every retransmission follows a failed attempt, so does the last
+	// attempt of a frame that ran out of retries. CCA failures are a busy
+	// channel, more power does not help there.
+	counters.attempts = mac->mTxAckRequested + mac->mTxRetry;
+	counters.failed = mac->mTxRetry + mac->mTxDirectMaxRetryExpiry;
+
+	return counters;
+}
+
+bool TxPower::ParentRssi(otInstance *instance, int8_t &rssi)
+{
+	return otThreadGetParentAverageRssi(instance, &rssi) == OT_ERROR_NONE && rssi != OT_RADIO_RSSI_INVALID;
+}
+
+int TxPower::MarginDb(otInstance *instance, int8_t rssi, int power)
+{
+	// As if the parent sent at our highest power and heard as well as we do
+	return rssi - otPlatRadioGetReceiveSensitivity(instance) - (CONFIG_APP_TX_POWER_MAX_DBM - power);
+}
+
+void TxPower::SetPower(otInstance *instance, int power)
+{
+	power = CLAMP(power, CONFIG_APP_TX_POWER_MIN_DBM, CONFIG_APP_TX_POWER_MAX_DBM);
+
+	if (power != power_dbm && otPlatRadioSetTransmitPower(instance, power) == OT_ERROR_NONE) {
+		power_dbm = power;
+	}
+}
+
+bool TxPower::CheckParent(otInstance *instance)
+{
+	otRouterInfo info;
+
+	// Detached, keep what worked until a parent is found
+	if (otThreadGetParentInfo(instance, &info) != OT_ERROR_NONE) {
+		return false;
+	}
+
+	if (has_parent && memcmp(&info.mExtAddress, &parent, sizeof(parent)) == 0) {
+		return false;
+	}
+
+	parent = info.mExtAddress;
+	has_parent = true;
+	floor_dbm = INT8_MIN;
+	windows = 0;
+	start = Take(instance);
+
+	int8_t rssi;
+
+	if (!ParentRssi(instance, rssi)) {
+		LOG_INF("New parent 0x%04x, TX power %d dBm", info.mRloc16, power_dbm);
+		return true;
+	}
+
+	// Start where the estimated margin is CONFIG_APP_TX_POWER_LINK_MARGIN_DB
+	int margin = MarginDb(instance, rssi, CONFIG_APP_TX_POWER_MAX_DBM);
+	SetPower(instance, CONFIG_APP_TX_POWER_MAX_DBM - margin + CONFIG_APP_TX_POWER_LINK_MARGIN_DB);
+
+	LOG_INF("New parent 0x%04x, RSSI %d dBm, TX power %d dBm", info.mRloc16, rssi, power_dbm);
+
+	return true;
+}
+
+void TxPower::Evaluate()
+{
+	ThreadStackMgr().LockThreadStack();
+
+	otInstance *instance = ThreadStackMgrImpl().OTInstance();
+
+	// Also catches a parent change without a role change
+	CheckParent(instance);
+
+	Counters now = Take(instance);
+	uint32_t attempts = now.attempts - start.attempts;
+	uint32_t failed = now.failed - start.failed;
+
+	if (attempts < CONFIG_APP_TX_POWER_MIN_FRAMES) {
+		ThreadStackMgr().UnlockThreadStack();
+		return;
+	}
+
+	start = now;
+	retry_rate = static_cast<uint16_t>(MIN(uint64_t(failed) * 1000 / attempts, 1000));
+
+	if (++windows >= kFloorWindows) {
+		floor_dbm = INT8_MIN;
+		windows = 0;
+	}
+
+	int8_t previous = power_dbm;
+	int8_t rssi;
+
+	if (retry_rate > CONFIG_APP_TX_POWER_TARGET_FER) {
+		floor_dbm = MAX(floor_dbm, power_dbm);
+		windows = 0;
+		SetPower(instance, power_dbm + kStepUpDb);
+	} else if (retry_rate <= CONFIG_APP_TX_POWER_TARGET_FER / 2 && power_dbm - kStepDownDb > floor_dbm) {
+		int power = power_dbm - kStepDownDb;
+
+		if (!ParentRssi(instance, rssi) || MarginDb(instance, rssi, power) >= kMinMarginDb) {
+			SetPower(instance, power);
+		}
+	}
+
+	bool has_rssi = ParentRssi(instance, rssi);
+
+	ThreadStackMgr().UnlockThreadStack();
+
+	if (power_dbm != previous) {
+		LOG_INF("TX power %d dBm, %u of %u attempts failed, parent RSSI %d dBm", power_dbm, failed, attempts,
+			has_rssi ? rssi : OT_RADIO_RSSI_INVALID);
+	}
+}
+
+#endif // CONFIG_APP_TX_POWER_CONTROL
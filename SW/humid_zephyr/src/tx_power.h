@@ -0,0 +1,79 @@
+#pragma once
+
+// Closed-loop 802.15.4 TX power. The failed transmit attempts, MAC
+// retransmissions and frames that ran out of retries, are counted over
+// windows of at least CONFIG_APP_TX_POWER_MIN_FRAMES attempts, evaluated at
+// the end of ICD active periods:
+// - above CONFIG_APP_TX_POWER_TARGET_FER failed per mille, the power goes
+//   up 3 dB and the failing power is remembered as floor,
+// - below half of it, it goes down 1 dB, as long as it stays above the
+//   floor and the estimated link margin to the parent stays at least 6 dB.
+// The margin is estimated from the parent's average RSSI, as if the parent
+// sent at CONFIG_APP_TX_POWER_MAX_DBM. On a new parent the floor is
+// dropped and the power starts where the estimate gives
+// CONFIG_APP_TX_POWER_LINK_MARGIN_DB. The floor also expires after a
+// number of windows, so the power follows a link that got better.
+
+#include <lib/core/CHIPError.h>
+
+#include <stdint.h>
+
+#if CONFIG_APP_TX_POWER_CONTROL
+
+#include <app/icd/server/ICDStateObserver.h>
+#include <platform/CHIPDeviceEvent.h>
+
+#include <openthread/thread.h>
+
+class TxPower : public chip::app::ICDStateObserver {
+public:
+	// Call after Server::Init()
+	CHIP_ERROR Init();
+
+	void OnEnterActiveMode() override {}
+	void OnTransitionToIdle() override {}
+	void OnEnterIdleMode() override;
+	void OnICDModeChange() override {}
+
+	// TX power in dBm the controller set
+	int8_t PowerDbm() const { return power_dbm; }
+
+	// Failed transmit attempts per mille over the last full window
+	uint16_t RetryRate() const { return retry_rate; }
+
+private:
+	struct Counters {
+		uint32_t attempts;
+		uint32_t failed;
+	};
+
+	static void ChipEventHandler(const chip::DeviceLayer::ChipDeviceEvent *event, intptr_t arg);
+
+	// Call with the Thread stack locked
+	Counters Take(otInstance *instance);
+	bool CheckParent(otInstance *instance);
+	bool ParentRssi(otInstance *instance, int8_t &rssi);
+	int MarginDb(otInstance *instance, int8_t rssi, int power);
+	void SetPower(otInstance *instance, int power);
+
+	void Evaluate();
+
+	otExtAddress parent = {};
+	bool has_parent = false;
+	Counters start = {};
+	int8_t power_dbm = 0;
+	int8_t floor_dbm = INT8_MIN;
+	uint16_t retry_rate = 0;
+	uint16_t windows = 0;
+};
+
+#else
+
+class TxPower {
+public:
+	CHIP_ERROR Init() { return CHIP_NO_ERROR; }
+	int8_t PowerDbm() const { return 0; }
+	uint16_t RetryRate() const { return 0; }
+};
+
+#endif // CONFIG_APP_TX_POWER_CONTROL
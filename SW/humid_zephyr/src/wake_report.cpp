@@ -0,0 +1,43 @@
+#include "wake_report.h"
+
+#include <app/InteractionModelEngine.h>
+#include <platform/CHIPDeviceLayer.h>
+#include <platform/ThreadStackManager.h>
+
+#include <openthread/link.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(wake_report, CONFIG_CHIP_APP_LOG_LEVEL);
+
+using namespace ::chip;
+using namespace ::chip::DeviceLayer;
+
+CHIP_ERROR WakeReport::Init()
+{
+	app::InteractionModelEngine::GetInstance()->RegisterReadHandlerAppCallback(this);
+
+	return CHIP_NO_ERROR;
+}
+
+void WakeReport::OnSubscriptionEstablished(app::ReadHandler &handler)
+{
+	if (reported) {
+		return;
+	}
+
+	reported = true;
+
+	uint32_t elapsed_ms = k_uptime_get_32();
+
+	// The MAC counters start at zero with the stack on every boot
+	ThreadStackMgr().LockThreadStack();
+	const otMacCounters *mac = otLinkGetCounters(ThreadStackMgrImpl().OTInstance());
+	uint32_t tx_frames = mac->mTxTotal;
+	uint32_t rx_frames = mac->mRxTotal;
+	ThreadStackMgr().UnlockThreadStack();
+
+	LOG_INF("First report delivered %u ms after boot, subscription 0x%08x, %u frames sent, %u received",
+		elapsed_ms, handler.GetSubscriptionId(), tx_frames, rx_frames);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <app/ReadHandler.h>
+#include <lib/core/CHIPError.h>
+
+#include <stdint.h>
+
+// Measures how long a boot, including every wake from System OFF, takes to
+// deliver its first report. A subscription counts as established once its
+// priming report was acknowledged, for a resumed subscription that is the
+// first report after the wake. The time since kernel start and the 802.15.4
+// frames sent and received until then are logged once per boot, to compare
+// builds with and without CONFIG_APP_KVS_CACHE.
+class WakeReport : public chip::app::ReadHandler::ApplicationCallback {
+public:
+	// Call after Server::Init()
+	CHIP_ERROR Init();
+
+	void OnSubscriptionEstablished(chip::app::ReadHandler &handler) override;
+
+private:
+	bool reported = false;
+};
@@ -37,6 +37,50 @@ namespace app {
 
 namespace Clusters {
 
+namespace DiagnosticLogs {
+
+Protocols::InteractionModel::Status DispatchServerCommand(
+    CommandHandler* apCommandObj, const ConcreteCommandPath& aCommandPath,
+    TLV::TLVReader& aDataTlv) {
+  CHIP_ERROR TLVError = CHIP_NO_ERROR;
+  bool wasHandled = false;
+  {
+    switch (aCommandPath.mCommandId) {
+      case Commands::RetrieveLogsRequest::Id: {
+        Commands::RetrieveLogsRequest::DecodableType commandData;
+        TLVError = DataModel::Decode(aDataTlv, commandData);
+        if (TLVError == CHIP_NO_ERROR) {
+          wasHandled = emberAfDiagnosticLogsClusterRetrieveLogsRequestCallback(
+              apCommandObj, aCommandPath, commandData);
+        }
+        break;
+      }
+      default: {
+        // Unrecognized command ID, error status will apply.
+        ChipLogError(Zcl,
+                     "Unknown command " ChipLogFormatMEI
+                     " for cluster " ChipLogFormatMEI,
+                     ChipLogValueMEI(aCommandPath.mCommandId),
+                     ChipLogValueMEI(aCommandPath.mClusterId));
+        return Protocols::InteractionModel::Status::UnsupportedCommand;
+      }
+    }
+  }
+
+  if (CHIP_NO_ERROR != TLVError || !wasHandled) {
+    ChipLogProgress(Zcl,
+                    "Failed to dispatch command, TLVError=%" CHIP_ERROR_FORMAT,
+                    TLVError.Format());
+    return Protocols::InteractionModel::Status::InvalidCommand;
+  }
+
+  // We use success as a marker that no special handling is required
+  // This is to avoid having a std::optional which uses slightly more code.
+  return Protocols::InteractionModel::Status::Success;
+}
+
+}  // namespace DiagnosticLogs
+
 namespace GroupKeyManagement {
 
 Protocols::InteractionModel::Status DispatchServerCommand(
@@ -354,6 +398,10 @@ void DispatchSingleClusterCommand(const ConcreteCommandPath& aCommandPath,
       Protocols::InteractionModel::Status::Success;
 
   switch (aCommandPath.mClusterId) {
+    case Clusters::DiagnosticLogs::Id:
+      errorStatus = Clusters::DiagnosticLogs::DispatchServerCommand(
+          apCommandObj, aCommandPath, aReader);
+      break;
     case Clusters::GroupKeyManagement::Id:
       errorStatus = Clusters::GroupKeyManagement::DispatchServerCommand(
           apCommandObj, aCommandPath, aReader);
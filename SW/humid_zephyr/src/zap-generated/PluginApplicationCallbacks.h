@@ -27,6 +27,7 @@ void MatterOtaSoftwareUpdateRequestorPluginServerInitCallback();
 void MatterPowerSourcePluginServerInitCallback();
 void MatterGeneralCommissioningPluginServerInitCallback();
 void MatterNetworkCommissioningPluginServerInitCallback();
+void MatterDiagnosticLogsPluginServerInitCallback();
 void MatterGeneralDiagnosticsPluginServerInitCallback();
 void MatterThreadNetworkDiagnosticsPluginServerInitCallback();
 void MatterAdministratorCommissioningPluginServerInitCallback();
@@ -35,6 +36,9 @@ void MatterGroupKeyManagementPluginServerInitCallback();
 void MatterTemperatureMeasurementPluginServerInitCallback();
 void MatterRelativeHumidityMeasurementPluginServerInitCallback();
 void MatterSoilMeasurementPluginServerInitCallback();
+void MatterHumidDiagnosticsPluginServerInitCallback();
+void MatterHumidSamplesPluginServerInitCallback();
+void MatterBooleanStatePluginServerInitCallback();
 
 #define MATTER_PLUGINS_INIT                                    \
   MatterIdentifyPluginServerInitCallback();                    \
@@ -45,6 +49,7 @@ void MatterSoilMeasurementPluginServerInitCallback();
   MatterPowerSourcePluginServerInitCallback();                 \
   MatterGeneralCommissioningPluginServerInitCallback();        \
   MatterNetworkCommissioningPluginServerInitCallback();        \
+  MatterDiagnosticLogsPluginServerInitCallback();              \
   MatterGeneralDiagnosticsPluginServerInitCallback();          \
   MatterThreadNetworkDiagnosticsPluginServerInitCallback();    \
   MatterAdministratorCommissioningPluginServerInitCallback();  \
@@ -52,4 +57,7 @@ void MatterSoilMeasurementPluginServerInitCallback();
   MatterGroupKeyManagementPluginServerInitCallback();          \
   MatterTemperatureMeasurementPluginServerInitCallback();      \
   MatterRelativeHumidityMeasurementPluginServerInitCallback(); \
-  MatterSoilMeasurementPluginServerInitCallback();
+  MatterSoilMeasurementPluginServerInitCallback();             \
+  MatterHumidDiagnosticsPluginServerInitCallback();            \
+  MatterHumidSamplesPluginServerInitCallback();                \
+  MatterBooleanStatePluginServerInitCallback();
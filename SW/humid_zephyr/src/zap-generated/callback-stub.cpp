@@ -36,9 +36,15 @@ void emberAfClusterInitCallback(EndpointId endpoint, ClusterId clusterId) {
     case app::Clusters::BasicInformation::Id:
       emberAfBasicInformationClusterInitCallback(endpoint);
       break;
+    case app::Clusters::BooleanState::Id:
+      emberAfBooleanStateClusterInitCallback(endpoint);
+      break;
     case app::Clusters::Descriptor::Id:
       emberAfDescriptorClusterInitCallback(endpoint);
       break;
+    case app::Clusters::DiagnosticLogs::Id:
+      emberAfDiagnosticLogsClusterInitCallback(endpoint);
+      break;
     case app::Clusters::GeneralCommissioning::Id:
       emberAfGeneralCommissioningClusterInitCallback(endpoint);
       break;
@@ -100,11 +106,21 @@ emberAfBasicInformationClusterInitCallback(EndpointId endpoint) {
   (void)endpoint;
 }
 void __attribute__((weak))
+emberAfBooleanStateClusterInitCallback(EndpointId endpoint) {
+  // To prevent warning
+  (void)endpoint;
+}
+void __attribute__((weak))
 emberAfDescriptorClusterInitCallback(EndpointId endpoint) {
   // To prevent warning
   (void)endpoint;
 }
 void __attribute__((weak))
+emberAfDiagnosticLogsClusterInitCallback(EndpointId endpoint) {
+  // To prevent warning
+  (void)endpoint;
+}
+void __attribute__((weak))
 emberAfGeneralCommissioningClusterInitCallback(EndpointId endpoint) {
   // To prevent warning
   (void)endpoint;
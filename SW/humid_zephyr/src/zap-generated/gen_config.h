@@ -41,7 +41,7 @@
 #define MATTER_DM_POWER_SOURCE_CLUSTER_SERVER_ENDPOINT_COUNT (1)
 #define MATTER_DM_GENERAL_COMMISSIONING_CLUSTER_SERVER_ENDPOINT_COUNT (1)
 #define MATTER_DM_NETWORK_COMMISSIONING_CLUSTER_SERVER_ENDPOINT_COUNT (1)
-#define MATTER_DM_DIAGNOSTIC_LOGS_CLUSTER_SERVER_ENDPOINT_COUNT (0)
+#define MATTER_DM_DIAGNOSTIC_LOGS_CLUSTER_SERVER_ENDPOINT_COUNT (1)
 #define MATTER_DM_GENERAL_DIAGNOSTICS_CLUSTER_SERVER_ENDPOINT_COUNT (1)
 #define MATTER_DM_SOFTWARE_DIAGNOSTICS_CLUSTER_SERVER_ENDPOINT_COUNT (0)
 #define MATTER_DM_THREAD_NETWORK_DIAGNOSTICS_CLUSTER_SERVER_ENDPOINT_COUNT (1)
@@ -59,7 +59,7 @@
 #define MATTER_DM_PROXY_CONFIGURATION_CLUSTER_SERVER_ENDPOINT_COUNT (0)
 #define MATTER_DM_PROXY_DISCOVERY_CLUSTER_SERVER_ENDPOINT_COUNT (0)
 #define MATTER_DM_PROXY_VALID_CLUSTER_SERVER_ENDPOINT_COUNT (0)
-#define MATTER_DM_BOOLEAN_STATE_CLUSTER_SERVER_ENDPOINT_COUNT (0)
+#define MATTER_DM_BOOLEAN_STATE_CLUSTER_SERVER_ENDPOINT_COUNT (1)
 #define MATTER_DM_ICD_MANAGEMENT_CLUSTER_SERVER_ENDPOINT_COUNT (0)
 #define MATTER_DM_TIMER_CLUSTER_SERVER_ENDPOINT_COUNT (0)
 #define MATTER_DM_OPERATIONAL_STATE_OVEN_CLUSTER_SERVER_ENDPOINT_COUNT (0)
@@ -183,6 +183,8 @@
 #define MATTER_DM_UNIT_TESTING_CLUSTER_SERVER_ENDPOINT_COUNT (0)
 #define MATTER_DM_FAULT_INJECTION_CLUSTER_SERVER_ENDPOINT_COUNT (0)
 #define MATTER_DM_SAMPLE_MEI_CLUSTER_SERVER_ENDPOINT_COUNT (0)
+#define MATTER_DM_HUMID_DIAGNOSTICS_CLUSTER_SERVER_ENDPOINT_COUNT (1)
+#define MATTER_DM_HUMID_SAMPLES_CLUSTER_SERVER_ENDPOINT_COUNT (1)
 
 #define MATTER_DM_IDENTIFY_CLUSTER_CLIENT_ENDPOINT_COUNT (0)
 #define MATTER_DM_GROUPS_CLUSTER_CLIENT_ENDPOINT_COUNT (0)
@@ -450,6 +452,18 @@
 #define MATTER_DM_PLUGIN_SOIL_MEASUREMENT_SERVER
 #define MATTER_DM_PLUGIN_SOIL_MEASUREMENT
 
+// Use this macro to check if the server side of the Humid Diagnostics cluster
+// is included
+#define ZCL_USING_HUMID_DIAGNOSTICS_CLUSTER_SERVER
+#define MATTER_DM_PLUGIN_HUMID_DIAGNOSTICS_SERVER
+#define MATTER_DM_PLUGIN_HUMID_DIAGNOSTICS
+
+// Use this macro to check if the server side of the Humid Samples cluster
+// is included
+#define ZCL_USING_HUMID_SAMPLES_CLUSTER_SERVER
+#define MATTER_DM_PLUGIN_HUMID_SAMPLES_SERVER
+#define MATTER_DM_PLUGIN_HUMID_SAMPLES
+
 /**** Cluster Commands Flag ****/
 //  AdministratorCommissioning Cluster Commands
 #define ADMINISTRATOR_COMMISSIONING_ENABLE_OPEN_COMMISSIONING_WINDOW_CMD 1
@@ -0,0 +1,2 @@
+# MCUboot image check hook for fast resume from System OFF, see src/boot_resume.h
+set(mcuboot_EXTRA_ZEPHYR_MODULES ${CMAKE_CURRENT_LIST_DIR}/mcuboot_hooks CACHE INTERNAL "MCUboot hook module")
@@ -0,0 +1,60 @@
+#include "adaptive_interval.h"
+
+#include <zephyr/sys/util.h>
+#include <zephyr/ztest.h>
+
+namespace {
+
+constexpr int16_t kTemperature = 2100;
+constexpr uint16_t kHumidity = 4500;
+
+// Peak to peak noise right at the floor, around a flat reading
+int16_t NoisyTemperature(int i)
+{
+	int32_t noise = MAX(CONFIG_APP_ADAPTIVE_TEMP_NOISE, CONFIG_APP_REPORT_TEMP_DELTA);
+
+	return kTemperature + (i % 2 ? noise / 2 : -noise / 2);
+}
+
+uint16_t NoisyHumidity(int i)
+{
+	int32_t noise = MAX(CONFIG_APP_ADAPTIVE_HUMIDITY_NOISE, CONFIG_APP_REPORT_HUMIDITY_DELTA);
+
+	return kHumidity + (i % 2 ? -noise / 2 : noise / 2);
+}
+
+} // namespace
+
+ZTEST(adaptive_interval, test_noisy_flat_trace_backs_off_to_max)
+{
+	AdaptiveInterval interval;
+
+	interval.Init();
+	interval.Restore(CONFIG_APP_MEASUREMENT_INTERVAL_MIN_SEC, NoisyTemperature(0), NoisyHumidity(0), true);
+
+	for (int i = 1; interval.IntervalSec() < CONFIG_APP_MEASUREMENT_INTERVAL_MAX_SEC; i++) {
+		uint32_t previous_sec = interval.IntervalSec();
+		uint32_t next_sec = interval.Update(NoisyTemperature(i), NoisyHumidity(i), previous_sec * 1000LL);
+
+		zassert_equal(next_sec, MIN(previous_sec * 2, CONFIG_APP_MEASUREMENT_INTERVAL_MAX_SEC),
+			      "Noise at %u s changed the interval to %u s", previous_sec, next_sec);
+	}
+
+	zassert_true(interval.Stable());
+}
+
+ZTEST(adaptive_interval, test_step_drops_to_min)
+{
+	AdaptiveInterval interval;
+
+	interval.Init();
+	interval.Restore(CONFIG_APP_MEASUREMENT_INTERVAL_MAX_SEC, kTemperature, kHumidity, true);
+
+	// A shower: 2 C and 20 %RH within one minimum interval
+	zassert_equal(interval.Update(kTemperature + 200, kHumidity + 2000,
+				      CONFIG_APP_MEASUREMENT_INTERVAL_MIN_SEC * 1000LL),
+		      CONFIG_APP_MEASUREMENT_INTERVAL_MIN_SEC);
+	zassert_false(interval.Stable());
+}
+
+ZTEST_SUITE(adaptive_interval, NULL, NULL, NULL, NULL, NULL);